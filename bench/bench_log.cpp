@@ -0,0 +1,18 @@
+// Stand-in for xplib's log_msg.cpp, which needs XPLMDebugString
+
+#include <cstdarg>
+#include <cstdio>
+
+#include "log_msg.h"
+
+const char *log_msg_prefix = "bench: ";
+
+void LogMsg(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    fputs(log_msg_prefix, stderr);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
@@ -0,0 +1,86 @@
+// DataRefTable check against a stand-in for X-Plane's dataref registry
+//
+// Walks the handle table through the cases XPlane.dataref.find() and the
+// handle getters rely on: unknown names, handles surviving ReleaseAll() and
+// resolving to the dataref registered after it (aircraft change), and
+// pending handles of datarefs that another plugin registers later, looked
+// up no more than once per retry interval. Needs neither X-Plane nor GL:
+//
+//   build/bench/dataref_check
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include "dataref_table.h"
+
+// Registered datarefs, and how often the table asked for one
+static std::map<std::string, XPLMDataRef> registry;
+static int lookups = 0;
+
+static XPLMDataRef Register(const std::string &name, uintptr_t id)
+{
+    XPLMDataRef ref = reinterpret_cast<XPLMDataRef>(id);
+    registry[name] = ref;
+    return ref;
+}
+
+XPLMDataRef XPLMFindDataRef(const char *inDataRefName)
+{
+    lookups++;
+    auto it = registry.find(inDataRefName);
+    return it != registry.end() ? it->second : nullptr;
+}
+
+static bool Expect(bool ok, const char *what)
+{
+    printf("%-56s %s\n", what, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main()
+{
+    bool ok = true;
+    double now = 100.0;
+    DataRefTable table;
+
+    XPLMDataRef altitude = Register("sim/flightmodel/position/elevation", 1);
+    int handle = table.Find("sim/flightmodel/position/elevation", false, now);
+    ok &= Expect(handle == 1, "find() of a registered dataref");
+    ok &= Expect(table.Resolve(handle, now) == altitude, "handle resolves to its dataref");
+    ok &= Expect(table.Find("sim/flightmodel/position/elevation", false, now) == handle, "same name, same handle");
+    ok &= Expect(table.Find("sim/does/not/exist", false, now) == 0, "find() of a missing dataref is 0");
+    ok &= Expect(table.size() == 1, "a failed find() leaves no handle behind");
+    ok &= Expect(table.Resolve(0, now) == nullptr && table.Resolve(2, now) == nullptr, "invalid handles resolve to nullptr");
+    ok &= Expect(table.Name(handle) == "sim/flightmodel/position/elevation" && table.Name(7) == "#7", "handle names");
+
+    // Aircraft change: the old aircraft's plugin is gone, the new one registers the same path
+    XPLMDataRef aircraft = Register("acf/custom/value", 2);
+    int acf_handle = table.Find("acf/custom/value", false, now);
+    table.Release();
+    registry.erase("acf/custom/value");
+    XPLMDataRef reloaded = Register("acf/custom/value", 3);
+    ok &= Expect(table.size() == 2, "ReleaseAll() keeps the handles");
+    ok &= Expect(table.Resolve(handle, now) == altitude, "stale handle resolves again after ReleaseAll()");
+    ok &= Expect(table.Resolve(acf_handle, now) == reloaded && reloaded != aircraft,
+                 "stale handle resolves to the re-registered dataref");
+    lookups = 0;
+    table.Resolve(acf_handle, now);
+    ok &= Expect(lookups == 0, "a resolved handle is not looked up again");
+
+    // Declared before the plugin that owns it registered it (readMany, subscribe, snapshot)
+    int pending = table.Find("plugin/late/value", true, now);
+    ok &= Expect(pending == 3, "pending handle for a missing dataref");
+    ok &= Expect(table.Find("plugin/late/value", false, now) == 0, "find() still reports it missing");
+    XPLMDataRef late = Register("plugin/late/value", 4);
+    lookups = 0;
+    ok &= Expect(table.Resolve(pending, now + DataRefTable::kRetryInterval / 2) == nullptr && lookups == 0,
+                 "no lookup within the retry interval");
+    ok &= Expect(table.Resolve(pending, now + DataRefTable::kRetryInterval) == late && lookups == 1,
+                 "pending handle resolves once registered");
+    ok &= Expect(table.Find("plugin/late/value", false, now) == pending, "find() returns the pending handle");
+
+    printf("\n%s\n", ok ? "all checks passed" : "some checks FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+// GPUDriverGL smoke test and draw timing
+//
+// Feeds GPUDriverGL the same calls Renderer::Render() makes for a small
+// accelerated view (render target, quad geometry, path geometry, command
+// list) on a headless EGL context, then reads the render target back to
+// check the shaders compiled, the output is top-down and X-Plane's GL
+// bindings were restored. Meant to run under Mesa software GL:
+//
+//   LIBGL_ALWAYS_SOFTWARE=1 build/bench/gpu_driver_check [frames]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "headless_gl.h"
+#include "gpu_driver_gl.h"
+
+static const uint32_t kWidth = 256;
+static const uint32_t kHeight = 128;
+
+static GPUState DefaultState(uint32_t render_buffer_id, ShaderType shader)
+{
+    GPUState state = {};
+    state.viewport_width = kWidth;
+    state.viewport_height = kHeight;
+    state.transform.data[0] = state.transform.data[5] = state.transform.data[10] = state.transform.data[15] = 1.0f;
+    state.enable_blend = true;
+    state.shader_type = shader;
+    state.render_buffer_id = render_buffer_id;
+    return state;
+}
+
+static Vertex_2f_4ub_2f_2f_28f QuadVertex(float x, float y, const unsigned char color[4])
+{
+    Vertex_2f_4ub_2f_2f_28f v;
+    memset(&v, 0, sizeof(v));
+    v.pos[0] = x;
+    v.pos[1] = y;
+    memcpy(v.color, color, 4);
+    v.obj[0] = x;
+    v.obj[1] = y;
+    v.data0[0] = 0.0f;  // FillType_Solid
+    return v;
+}
+
+static Vertex_2f_4ub_2f PathVertex(float x, float y, const unsigned char color[4])
+{
+    Vertex_2f_4ub_2f v;
+    memset(&v, 0, sizeof(v));
+    v.pos[0] = x;
+    v.pos[1] = y;
+    memcpy(v.color, color, 4);
+    return v;
+}
+
+// BGRA pixel of the render target at view coordinates (x, y)
+static const uint8_t *Pixel(const std::vector<uint8_t> &pixels, int x, int y)
+{
+    return &pixels[(static_cast<size_t>(y) * kWidth + x) * 4];
+}
+
+static bool Expect(bool ok, const char *what)
+{
+    printf("%-48s %s\n", what, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 200;
+    if (frames <= 0)
+        frames = 1;
+
+    HeadlessGL gl;
+    if (!gl.Create())
+        return 1;
+
+    GLExt::Load();
+    printf("GL_RENDERER: %s\n", glGetString(GL_RENDERER));
+    printf("GL_VERSION:  %s\n\n", glGetString(GL_VERSION));
+    if (!GLExt::HasShaderPipeline())
+    {
+        fprintf(stderr, "OpenGL 3.2 shader pipeline not available\n");
+        return 1;
+    }
+
+    GPUDriverGL &driver = GPUDriverGL::instance();
+
+    // Stand-in for whatever X-Plane had bound, must survive the driver
+    GLuint sentinel = 0;
+    glGenTextures(1, &sentinel);
+    glBindTexture(GL_TEXTURE_2D, sentinel);
+
+    // Red quad over the top half, green path triangle in the bottom-left corner
+    const unsigned char red[4] = {255, 0, 0, 255};
+    const unsigned char green[4] = {0, 255, 0, 255};
+    Vertex_2f_4ub_2f_2f_28f quad[4] = {
+        QuadVertex(0, 0, red), QuadVertex(kWidth, 0, red),
+        QuadVertex(kWidth, kHeight / 2.0f, red), QuadVertex(0, kHeight / 2.0f, red)};
+    uint32_t quad_indices[6] = {0, 1, 2, 0, 2, 3};
+    Vertex_2f_4ub_2f path[3] = {
+        PathVertex(0, kHeight / 2.0f, green), PathVertex(kWidth / 2.0f, kHeight, green),
+        PathVertex(0, kHeight, green)};
+    uint32_t path_indices[3] = {0, 1, 2};
+
+    driver.BeginSynchronize();
+    uint32_t texture_id = driver.NextTextureId();
+    driver.CreateTexture(texture_id, Bitmap::Create(kWidth, kHeight, BitmapFormat::BGRA8_UNORM_SRGB));
+    uint32_t render_buffer_id = driver.NextRenderBufferId();
+    driver.CreateRenderBuffer(render_buffer_id, {texture_id, kWidth, kHeight, false, false});
+    uint32_t quad_id = driver.NextGeometryId();
+    driver.CreateGeometry(quad_id, {VertexBufferFormat::_2f_4ub_2f_2f_28f, sizeof(quad), reinterpret_cast<uint8_t *>(quad)},
+                          {sizeof(quad_indices), reinterpret_cast<uint8_t *>(quad_indices)});
+    uint32_t path_id = driver.NextGeometryId();
+    driver.CreateGeometry(path_id, {VertexBufferFormat::_2f_4ub_2f, sizeof(path), reinterpret_cast<uint8_t *>(path)},
+                          {sizeof(path_indices), reinterpret_cast<uint8_t *>(path_indices)});
+    driver.EndSynchronize();
+
+    std::vector<Command> commands(3);
+    commands[0].command_type = CommandType::ClearRenderBuffer;
+    commands[0].gpu_state = DefaultState(render_buffer_id, ShaderType::Fill);
+    commands[1].command_type = CommandType::DrawGeometry;
+    commands[1].gpu_state = DefaultState(render_buffer_id, ShaderType::Fill);
+    commands[1].geometry_id = quad_id;
+    commands[1].indices_count = 6;
+    commands[2].command_type = CommandType::DrawGeometry;
+    commands[2].gpu_state = DefaultState(render_buffer_id, ShaderType::FillPath);
+    commands[2].geometry_id = path_id;
+    commands[2].indices_count = 3;
+    CommandList list = {static_cast<uint32_t>(commands.size()), commands.data()};
+
+    // First list compiles the programs, keep it out of the timing
+    driver.UpdateCommandList(list);
+    driver.DrawCommandList();
+    glFinish();
+
+    double total_us = 0.0;
+    for (int i = 0; i < frames; i++)
+    {
+        driver.UpdateCommandList(list);
+        auto start = std::chrono::steady_clock::now();
+        driver.DrawCommandList();
+        glFinish();
+        total_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    GLint bound = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound);
+    GLint program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+
+    std::vector<uint8_t> pixels(static_cast<size_t>(kWidth) * kHeight * 4);
+    glBindTexture(GL_TEXTURE_2D, driver.GetGLTexture(texture_id));
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_BGRA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, sentinel);
+
+    const uint8_t *top = Pixel(pixels, kWidth / 2, 4);
+    const uint8_t *bottom_left = Pixel(pixels, 4, kHeight - 4);
+    const uint8_t *bottom_right = Pixel(pixels, kWidth - 4, kHeight - 4);
+
+    bool ok = true;
+    ok &= Expect(glGetError() == GL_NO_ERROR, "no GL errors");
+    ok &= Expect(top[2] == 255 && top[1] == 0 && top[3] == 255, "quad shader fills the top half (row 0 = top)");
+    ok &= Expect(bottom_left[1] == 255 && bottom_left[2] == 0, "path shader fills the bottom-left triangle");
+    ok &= Expect(bottom_right[3] == 0, "cleared pixels stay transparent");
+    ok &= Expect(bound == static_cast<GLint>(sentinel), "texture binding restored");
+    ok &= Expect(program == 0, "program binding restored");
+
+    printf("\n%ux%u render target, %d frames, %.1f us per command list\n",
+           kWidth, kHeight, frames, total_us / frames);
+
+    driver.Shutdown();
+    glDeleteTextures(1, &sentinel);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+#include "headless_gl.h"
+
+#include <cstdio>
+
+HeadlessGL::~HeadlessGL()
+{
+    if (display_ == EGL_NO_DISPLAY)
+        return;
+
+    eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context_ != EGL_NO_CONTEXT)
+        eglDestroyContext(display_, context_);
+    if (surface_ != EGL_NO_SURFACE)
+        eglDestroySurface(display_, surface_);
+    eglTerminate(display_);
+}
+
+bool HeadlessGL::Create(int width, int height)
+{
+    // Prefer Mesa's surfaceless platform, it needs neither X11 nor a DRM device
+    auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (get_platform_display)
+        display_ = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display_ == EGL_NO_DISPLAY)
+        display_ = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (display_ == EGL_NO_DISPLAY || !eglInitialize(display_, &major, &minor))
+    {
+        fprintf(stderr, "HeadlessGL: eglInitialize failed (0x%x)\n", eglGetError());
+        return false;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        fprintf(stderr, "HeadlessGL: desktop OpenGL not supported by EGL %d.%d\n", major, minor);
+        return false;
+    }
+
+    const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE};
+    EGLConfig config;
+    EGLint num_configs = 0;
+    if (!eglChooseConfig(display_, config_attribs, &config, 1, &num_configs) || num_configs == 0)
+    {
+        fprintf(stderr, "HeadlessGL: no pbuffer config (0x%x)\n", eglGetError());
+        return false;
+    }
+
+    const EGLint pbuffer_attribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+    surface_ = eglCreatePbufferSurface(display_, config, pbuffer_attribs);
+    if (surface_ == EGL_NO_SURFACE)
+    {
+        fprintf(stderr, "HeadlessGL: eglCreatePbufferSurface failed (0x%x)\n", eglGetError());
+        return false;
+    }
+
+    // No profile attributes: a compatibility context, like the one X-Plane gives plugins
+    context_ = eglCreateContext(display_, config, EGL_NO_CONTEXT, nullptr);
+    if (context_ == EGL_NO_CONTEXT)
+    {
+        fprintf(stderr, "HeadlessGL: eglCreateContext failed (0x%x)\n", eglGetError());
+        return false;
+    }
+
+    if (!eglMakeCurrent(display_, surface_, surface_, context_))
+    {
+        fprintf(stderr, "HeadlessGL: eglMakeCurrent failed (0x%x)\n", eglGetError());
+        return false;
+    }
+    return true;
+}
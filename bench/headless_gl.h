@@ -0,0 +1,27 @@
+#pragma once
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+/**
+ * @brief Offscreen OpenGL context for running GL code without X-Plane
+ *
+ * Creates a compatibility-profile context on an EGL pbuffer, which works on
+ * a plain CI box with Mesa llvmpipe (LIBGL_ALWAYS_SOFTWARE=1) and no display.
+ */
+class HeadlessGL {
+public:
+    HeadlessGL() = default;
+    ~HeadlessGL();
+
+    HeadlessGL(const HeadlessGL &) = delete;
+    HeadlessGL &operator=(const HeadlessGL &) = delete;
+
+    // Create the context and make it current, returns false with a message on stderr
+    bool Create(int width = 16, int height = 16);
+
+private:
+    EGLDisplay display_ = EGL_NO_DISPLAY;
+    EGLSurface surface_ = EGL_NO_SURFACE;
+    EGLContext context_ = EGL_NO_CONTEXT;
+};
@@ -0,0 +1,367 @@
+// Headless app rendering benchmark and golden-image snapshots
+//
+// Creates an Ultralight Renderer without X-Plane, loads SkyScript apps and
+// renders them on the CPU for a number of frames at one or more view sizes.
+// For every app and size it writes
+//
+//   <out>/<app>_<W>x<H>.csv   per-frame update/paint time and dirty area
+//   <out>/<app>_<W>x<H>.png   the last frame, for eyeballing a failed check
+//   <out>/digests.txt         a pixel digest of every PNG
+//
+// and prints a summary table. With --golden the digests are compared against
+// a previous run's digests.txt and the exit code is 2 on any mismatch.
+// Apps are given relative to --root, which plays the part of the plugin
+// folder (resources/ for cacert.pem, apps/<name>/index.html):
+//
+//   build/bench/skyscript_render_bench --root /path/to/SkyScript
+//       --size 800x600 --size 1920x1080 --frames 120 apps/hello-world
+//
+// The pages run without the XPlane JS API, apps should already check for it.
+// Accelerated apps are rendered on the CPU as well.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Ultralight/Ultralight.h>
+#include <AppCore/Platform.h>
+
+#include "app_manifest.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+using namespace ultralight;
+
+struct Size {
+    uint32_t width;
+    uint32_t height;
+};
+
+struct Options {
+    std::string root = ".";
+    std::string out = "build/bench/render_out";
+    std::string golden;
+    std::vector<std::string> apps;
+    std::vector<Size> sizes;
+    int frames = 120;
+    double interval_ms = 1000.0 / 60.0;
+    double load_timeout = 10.0;
+};
+
+struct FrameStats {
+    double update_ms = 0.0;
+    double paint_ms = 0.0;  // 0 when the view wasn't dirty
+    uint32_t dirty_width = 0;
+    uint32_t dirty_height = 0;
+};
+
+class LoadWaiter : public LoadListener {
+public:
+    bool done = false;
+    bool failed = false;
+
+    virtual void OnFinishLoading(View *caller, uint64_t frame_id, bool is_main_frame, const String &url) override
+    {
+        if (is_main_frame)
+            done = true;
+    }
+
+    virtual void OnFailLoading(View *caller, uint64_t frame_id, bool is_main_frame, const String &url,
+                               const String &description, const String &error_domain, int error_code) override
+    {
+        if (is_main_frame)
+        {
+            fprintf(stderr, "load failed: %s (%s)\n", url.utf8().data(), description.utf8().data());
+            done = failed = true;
+        }
+    }
+};
+
+static double Seconds()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string FileName(const std::string &app, const Size &size)
+{
+    std::string name = app;
+    std::replace(name.begin(), name.end(), '/', '_');
+    std::replace(name.begin(), name.end(), '\\', '_');
+    return name + "_" + std::to_string(size.width) + "x" + std::to_string(size.height);
+}
+
+// FNV-1a over the visible pixels, row padding excluded
+static uint64_t Digest(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t row_bytes)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const uint8_t *row = pixels + static_cast<size_t>(y) * row_bytes;
+        for (uint32_t i = 0; i < width * 4; i++)
+        {
+            hash ^= row[i];
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+// BGRA surface to an RGBA PNG
+static bool WritePng(const std::string &path, const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t row_bytes)
+{
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const uint8_t *src = pixels + static_cast<size_t>(y) * row_bytes;
+        uint8_t *dst = rgba.data() + static_cast<size_t>(y) * width * 4;
+        for (uint32_t x = 0; x < width; x++)
+        {
+            dst[x * 4 + 0] = src[x * 4 + 2];
+            dst[x * 4 + 1] = src[x * 4 + 1];
+            dst[x * 4 + 2] = src[x * 4 + 0];
+            dst[x * 4 + 3] = src[x * 4 + 3];
+        }
+    }
+    return stbi_write_png(path.c_str(), width, height, 4, rgba.data(), width * 4) != 0;
+}
+
+static bool Run(Renderer *renderer, const Options &options, const std::string &app, const Size &size,
+                std::map<std::string, uint64_t> &digests)
+{
+    std::string name = FileName(app, size);
+
+    // Same render scale the plugin would use, auto mode starts at full size
+    AppManifest manifest;
+    manifest.Load((std::filesystem::path(options.root) / app).string());
+    double scale = manifest.GetString("renderScale", "") == "auto" ? 1.0
+                       : std::clamp(manifest.GetNumber("renderScale", 1.0), 0.25, 1.0);
+
+    ViewConfig config;
+    config.is_accelerated = false;
+    config.initial_device_scale = scale;
+    uint32_t width = std::max<uint32_t>(1, static_cast<uint32_t>(size.width * scale + 0.5));
+    uint32_t height = std::max<uint32_t>(1, static_cast<uint32_t>(size.height * scale + 0.5));
+
+    RefPtr<View> view = renderer->CreateView(width, height, config, nullptr);
+    LoadWaiter waiter;
+    view->set_load_listener(&waiter);
+    view->LoadURL(("file:///" + app + "/index.html").c_str());
+
+    double deadline = Seconds() + options.load_timeout;
+    while (!waiter.done && Seconds() < deadline)
+    {
+        renderer->Update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    view->set_load_listener(nullptr);
+    if (!waiter.done || waiter.failed)
+    {
+        fprintf(stderr, "%s: %s\n", name.c_str(), waiter.failed ? "failed to load" : "load timed out");
+        return false;
+    }
+
+    Surface *surface = view->surface();
+    std::vector<FrameStats> frames(options.frames);
+    View *views[] = {view.get()};
+
+    for (FrameStats &frame : frames)
+    {
+        double frame_start = Seconds();
+
+        double start = Seconds();
+        renderer->Update();
+        frame.update_ms = (Seconds() - start) * 1000.0;
+
+        if (view->needs_paint())
+        {
+            start = Seconds();
+            renderer->RenderOnly(views, 1);
+            frame.paint_ms = (Seconds() - start) * 1000.0;
+
+            IntRect dirty = surface->dirty_bounds();
+            if (dirty.IsValid())
+            {
+                frame.dirty_width = dirty.width();
+                frame.dirty_height = dirty.height();
+            }
+            surface->ClearDirtyBounds();
+        }
+
+        // Pace like the sim so timers and animations advance at their real rate
+        double rest = options.interval_ms / 1000.0 - (Seconds() - frame_start);
+        if (rest > 0.0)
+            std::this_thread::sleep_for(std::chrono::duration<double>(rest));
+    }
+
+    std::ofstream csv(std::filesystem::path(options.out) / (name + ".csv"));
+    csv << "frame,update_ms,paint_ms,dirty_width,dirty_height,dirty_pct\n";
+    double pixels = static_cast<double>(width) * height;
+    std::vector<double> paints;
+    double update_sum = 0.0, dirty_sum = 0.0;
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        const FrameStats &f = frames[i];
+        double dirty_pct = 100.0 * f.dirty_width * f.dirty_height / pixels;
+        csv << i << "," << f.update_ms << "," << f.paint_ms << "," << f.dirty_width << ","
+            << f.dirty_height << "," << dirty_pct << "\n";
+        update_sum += f.update_ms;
+        if (f.paint_ms > 0.0)
+        {
+            paints.push_back(f.paint_ms);
+            dirty_sum += dirty_pct;
+        }
+    }
+
+    void *locked = surface->LockPixels();
+    uint64_t digest = Digest(static_cast<const uint8_t *>(locked), width, height, surface->row_bytes());
+    bool written = WritePng((std::filesystem::path(options.out) / (name + ".png")).string(),
+                            static_cast<const uint8_t *>(locked), width, height, surface->row_bytes());
+    surface->UnlockPixels();
+    digests[name] = digest;
+    if (!written)
+        fprintf(stderr, "%s: failed to write PNG\n", name.c_str());
+
+    std::sort(paints.begin(), paints.end());
+    double paint_avg = 0.0;
+    for (double p : paints)
+        paint_avg += p;
+    size_t painted = paints.size();
+    if (painted)
+        paint_avg /= painted;
+    double paint_p99 = painted ? paints[std::min(painted - 1, painted * 99 / 100)] : 0.0;
+    double paint_max = painted ? paints.back() : 0.0;
+
+    printf("%-32s %9ux%-5u %5.2f %7zu %9.2f %9.2f %9.2f %9.2f %9.1f %10.2f\n", name.c_str(), width, height, scale,
+           painted, update_sum / frames.size(), paint_avg, paint_p99, paint_max,
+           painted ? dirty_sum / painted : 0.0, surface->size() / (1024.0 * 1024.0));
+    return true;
+}
+
+static bool ParseSize(const char *text, Size &size)
+{
+    unsigned w = 0, h = 0;
+    if (sscanf(text, "%ux%u", &w, &h) != 2 || w == 0 || h == 0)
+        return false;
+    size = {w, h};
+    return true;
+}
+
+static int Usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--root DIR] [--out DIR] [--golden DIR] [--size WxH]... [--frames N]\n"
+            "          [--interval MS] [--load-timeout S] APP_DIR...\n"
+            "  APP_DIR is relative to --root and holds index.html, e.g. apps/hello-world\n",
+            argv0);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--root" && has_value)
+            options.root = argv[++i];
+        else if (arg == "--out" && has_value)
+            options.out = argv[++i];
+        else if (arg == "--golden" && has_value)
+            options.golden = argv[++i];
+        else if (arg == "--frames" && has_value)
+            options.frames = atoi(argv[++i]);
+        else if (arg == "--interval" && has_value)
+            options.interval_ms = atof(argv[++i]);
+        else if (arg == "--load-timeout" && has_value)
+            options.load_timeout = atof(argv[++i]);
+        else if (arg == "--size" && has_value)
+        {
+            Size size;
+            if (!ParseSize(argv[++i], size))
+                return Usage(argv[0]);
+            options.sizes.push_back(size);
+        }
+        else if (arg.rfind("--", 0) == 0)
+            return Usage(argv[0]);
+        else
+            options.apps.push_back(arg);
+    }
+    if (options.apps.empty() || options.frames <= 0)
+        return Usage(argv[0]);
+    if (options.sizes.empty())
+        options.sizes.push_back({800, 600});
+
+    std::filesystem::create_directories(options.out);
+
+    // Same platform setup as the plugin, minus the GPU driver and upload surfaces
+    Config config;
+    config.user_stylesheet = "body { background-color: #202020; color: #E0E0E0; }";
+    Platform::instance().set_config(config);
+    Platform::instance().set_font_loader(GetPlatformFontLoader());
+    Platform::instance().set_file_system(GetPlatformFileSystem(options.root.c_str()));
+    Platform::instance().set_logger(GetDefaultLogger((options.out + "/ultralight.log").c_str()));
+    RefPtr<Renderer> renderer = Renderer::Create();
+
+    printf("%d frames every %.1f ms, paint = RenderOnly() of a dirty view, dirty = share of the view repainted\n",
+           options.frames, options.interval_ms);
+    printf("%-32s %15s %5s %7s %9s %9s %9s %9s %9s %10s\n", "view", "pixels", "scale", "painted",
+           "update ms", "paint ms", "p99 ms", "max ms", "dirty %", "bitmap MB");
+
+    int failures = 0;
+    std::map<std::string, uint64_t> digests;
+    for (const std::string &app : options.apps)
+    {
+        for (const Size &size : options.sizes)
+        {
+            if (!Run(renderer.get(), options, app, size, digests))
+                failures++;
+        }
+    }
+
+    std::ofstream out(std::filesystem::path(options.out) / "digests.txt");
+    for (const auto &[name, digest] : digests)
+        out << name << " " << std::hex << digest << std::dec << "\n";
+
+    int mismatches = 0;
+    if (!options.golden.empty())
+    {
+        std::ifstream golden(std::filesystem::path(options.golden) / "digests.txt");
+        if (!golden)
+        {
+            fprintf(stderr, "no digests.txt in %s\n", options.golden.c_str());
+            return 1;
+        }
+
+        std::string name;
+        uint64_t expected;
+        size_t compared = 0;
+        while (golden >> name >> std::hex >> expected >> std::dec)
+        {
+            auto it = digests.find(name);
+            if (it == digests.end())
+                continue;
+            compared++;
+            if (it->second != expected)
+            {
+                printf("MISMATCH %s (compare %s/%s.png)\n", name.c_str(), options.golden.c_str(), name.c_str());
+                mismatches++;
+            }
+        }
+        printf("golden: %zu compared, %d mismatched\n", compared, mismatches);
+    }
+
+    if (failures)
+        return 1;
+    return mismatches ? 2 : 0;
+}
@@ -0,0 +1,137 @@
+// Texture upload stall benchmark: direct glTexSubImage2D vs the PBO ring
+//
+// Runs TextureUploader against a headless EGL context and reports how long
+// each Upload() call blocks the calling thread, which is the time taken out
+// of X-Plane's frame. The last row is the plugin's default, which times both
+// paths on its first uploads and keeps the faster one. Meant to run under Mesa software GL:
+//
+//   LIBGL_ALWAYS_SOFTWARE=1 build/bench/upload_bench [frames] [width] [height]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "headless_gl.h"
+#include "texture_uploader.h"
+
+struct Scenario {
+    const char *name;
+    int width;   // dirty rectangle size, 0 = full surface
+    int height;
+};
+
+struct Stats {
+    double avg_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+    double finish_us = 0.0;
+    double mb = 0.0;
+};
+
+static Stats Run(TextureUploader::PixelBufferMode mode, const Scenario &scenario, int frames,
+                 uint32_t width, uint32_t height, uint32_t row_bytes, std::vector<uint8_t> &pixels)
+{
+    TextureUploader::set_pixel_buffer_mode(mode);
+    TextureUploader uploader;
+
+    IntRect full = {0, 0, static_cast<int>(width), static_cast<int>(height)};
+    uploader.Upload(pixels.data(), width, height, row_bytes, full);
+    glFinish();
+
+    std::vector<double> samples;
+    samples.reserve(frames);
+    size_t bytes = 0;
+    double finish_us = 0.0;
+
+    for (int i = 0; i < frames; i++)
+    {
+        int w = scenario.width ? scenario.width : static_cast<int>(width);
+        int h = scenario.height ? scenario.height : static_cast<int>(height);
+        int x = scenario.width ? (i * 37) % (static_cast<int>(width) - w) : 0;
+        int y = scenario.height ? (i * 23) % (static_cast<int>(height) - h) : 0;
+        IntRect dirty = {x, y, x + w, y + h};
+
+        // Touch the dirty pixels like a paint would
+        for (int row = y; row < y + h; row++)
+            memset(pixels.data() + static_cast<size_t>(row) * row_bytes + x * 4, i & 0xff, w * 4);
+
+        bytes += uploader.Upload(pixels.data(), width, height, row_bytes, dirty);
+        samples.push_back(uploader.last_upload_us());
+
+        // End of the sim frame: the driver gets the rest of the frame to finish the copy
+        glFlush();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    glFinish();
+    finish_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    Stats stats;
+    std::sort(samples.begin(), samples.end());
+    for (double s : samples)
+        stats.avg_us += s;
+    stats.avg_us /= samples.size();
+    stats.p99_us = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    stats.max_us = samples.back();
+    stats.finish_us = finish_us;
+    stats.mb = bytes / (1024.0 * 1024.0);
+    return stats;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 300;
+    uint32_t width = argc > 2 ? atoi(argv[2]) : 800;
+    uint32_t height = argc > 3 ? atoi(argv[3]) : 600;
+    if (frames <= 0 || width < 64 || height < 64)
+    {
+        fprintf(stderr, "usage: %s [frames] [width>=64] [height>=64]\n", argv[0]);
+        return 1;
+    }
+
+    HeadlessGL gl;
+    if (!gl.Create())
+        return 1;
+
+    GLExt::Load();
+    printf("GL_RENDERER: %s\n", glGetString(GL_RENDERER));
+    printf("GL_VERSION:  %s\n", glGetString(GL_VERSION));
+    printf("PBO path %s, fences %s\n\n", GLExt::HasPixelBuffers() ? "available" : "unavailable",
+           GLExt::HasSync() ? "available" : "unavailable");
+
+    // Pad rows the way Config::bitmap_alignment = 16 does
+    uint32_t row_bytes = (width * 4 + 15) & ~15u;
+    std::vector<uint8_t> pixels(static_cast<size_t>(row_bytes) * height, 0x80);
+
+    const Scenario scenarios[] = {
+        {"full frame", 0, 0},
+        {"panel 256x128", 256, 128},
+        {"cursor 2x20", 2, 20},
+    };
+
+    printf("%ux%u, %d frames per run, stall = time Upload() blocks the caller\n", width, height, frames);
+    printf("%-14s %-7s %10s %10s %10s %12s %10s\n",
+           "scenario", "path", "avg us", "p99 us", "max us", "finish us", "MB");
+
+    for (const Scenario &scenario : scenarios)
+    {
+        for (bool pixel_buffers : {false, true})
+        {
+            if (pixel_buffers && !GLExt::HasPixelBuffers())
+                continue;
+            Stats s = Run(pixel_buffers ? TextureUploader::kPixelBuffersOn : TextureUploader::kPixelBuffersOff,
+                          scenario, frames, width, height, row_bytes, pixels);
+            printf("%-14s %-7s %10.1f %10.1f %10.1f %12.1f %10.1f\n", scenario.name,
+                   pixel_buffers ? "pbo" : "direct", s.avg_us, s.p99_us, s.max_us, s.finish_us, s.mb);
+        }
+    }
+
+    // The plugin's default: measures both paths on the first full frames, then keeps one
+    Stats s = Run(TextureUploader::kPixelBuffersAuto, scenarios[0], frames, width, height, row_bytes, pixels);
+    printf("%-14s %-7s %10.1f %10.1f %10.1f %12.1f %10.1f\n", scenarios[0].name,
+           "auto", s.avg_us, s.p99_us, s.max_us, s.finish_us, s.mb);
+    return 0;
+}
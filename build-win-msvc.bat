@@ -26,7 +26,7 @@ REM /Zc:preprocessor - Enable conforming preprocessor (required for __VA_OPT__)
 REM /FI - Force include MSVC compatibility header to handle GCC-specific syntax
 set CXXFLAGS=/std:c++20 /O2 /EHsc /MD /W3 /Zc:preprocessor /FImsvc_compat.h
 set DEFINES=/DXPLM200 /DXPLM210 /DXPLM300 /DXPLM301 /DWINDOWS /DWIN32 /DIBM=1
-set INCLUDES=/I. /I..\xplib /I%SDK%\CHeaders\XPLM /IUltralight-SDK-1.4.0-Win64\include
+set INCLUDES=/I. /I..\xplib /I%SDK%\CHeaders\XPLM /IUltralight-SDK-1.4.0-Win64\include /IUltralight-SDK-1.4.0-Win64\shaders\glsl
 
 REM Compile source files from src directory (including subdirectories)
 echo Compiling source files...
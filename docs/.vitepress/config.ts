@@ -49,7 +49,8 @@ export default defineConfig({
             { text: 'DataRef API', link: '/api/DataRefAPI' },
             { text: 'Scenery API', link: '/api/SceneryAPI' },
             { text: 'Instance API', link: '/api/InstanceAPI' },
-            { text: 'Graphics API', link: '/api/GraphicsAPI' }
+            { text: 'Graphics API', link: '/api/GraphicsAPI' },
+            { text: 'App API', link: '/api/AppAPI' }
           ]
         }
       ]
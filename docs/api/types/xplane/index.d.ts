@@ -45,6 +45,53 @@ interface XPlaneAPI {
      * Graphics API for coordinate conversions
      */
     graphics: GraphicsAPI;
+
+    /**
+     * App lifecycle hooks
+     */
+    app: AppAPI;
+}
+
+/**
+ * Numeric dataref handle returned by find()
+ */
+type DataRefHandle = number;
+
+/**
+ * A dataref path or a handle from find(), accepted by every getter and setter
+ */
+type DataRefKey = string | DataRefHandle;
+
+/**
+ * Dataref set ID returned by defineSet()
+ */
+type DataRefSet = number;
+
+/**
+ * Subscription ID returned by subscribe()
+ */
+type DataRefSubscription = number;
+
+/**
+ * Per-frame dataref buffer returned by snapshot()
+ */
+interface DataRefSnapshot<K extends PropertyKey = string> {
+    /** Frame counter and values, refilled once per frame */
+    buffer: ArrayBuffer;
+    /** Float64Array over buffer, values[0] is the frame counter */
+    values: Float64Array;
+    /** Index in values of every name in the schema */
+    offsets: Record<K, number>;
+}
+
+/**
+ * Sampling options for subscribe()
+ */
+interface SubscribeOptions {
+    /** Samples per second (default: every frame) */
+    hz?: number;
+    /** Changes up to this size are ignored (default: 0, any change) */
+    epsilon?: number;
 }
 
 /**
@@ -92,28 +139,30 @@ interface DataRefAPI {
     // =========================================================================
 
     /**
-     * Check if a dataref exists
+     * Look up a dataref
      * 
      * @param name - The full path of the dataref (e.g., "sim/cockpit/radios/nav1_freq_hz")
-     * @returns `true` if the dataref exists, `null` otherwise
+     * @returns A handle for the dataref, or `null` if it doesn't exist. Handles are
+     * positive numbers, so the result can still be used as a boolean. Pass the handle
+     * instead of the name to any getter or setter to skip the name lookup.
      */
-    find(name: string): boolean | null;
+    find(name: string): DataRefHandle | null;
 
     /**
      * Check if a dataref is writable
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @returns `true` if writable, `false` if read-only or not found
      */
-    canWrite(name: string): boolean;
+    canWrite(dataref: DataRefKey): boolean;
 
     /**
      * Get the supported data types for a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @returns Object with boolean flags for each supported type, or `null` if not found
      */
-    getTypes(name: string): DataRefTypes | null;
+    getTypes(dataref: DataRefKey): DataRefTypes | null;
 
     // =========================================================================
     // Scalar Getters
@@ -122,26 +171,26 @@ interface DataRefAPI {
     /**
      * Read an integer value from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @returns The integer value, or 0 if the dataref is not found
      */
-    getInt(name: string): number;
+    getInt(dataref: DataRefKey): number;
 
     /**
      * Read a float value from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @returns The float value, or 0.0 if the dataref is not found
      */
-    getFloat(name: string): number;
+    getFloat(dataref: DataRefKey): number;
 
     /**
      * Read a double-precision value from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @returns The double value, or 0.0 if the dataref is not found
      */
-    getDouble(name: string): number;
+    getDouble(dataref: DataRefKey): number;
 
     // =========================================================================
     // Array Getters
@@ -150,32 +199,118 @@ interface DataRefAPI {
     /**
      * Read an integer array from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param offset - Start index in the array (default: 0)
      * @param count - Number of elements to read (default: all remaining)
-     * @returns Array of integers, or `null` if the dataref is not found
+     * @returns A new Int32Array, or `null` if the dataref is not found
      */
-    getIntArray(name: string, offset?: number, count?: number): number[] | null;
+    getIntArray(dataref: DataRefKey, offset?: number, count?: number): Int32Array | null;
+
+    /**
+     * Read an integer array dataref into an existing Int32Array, without allocating
+     * 
+     * @param dataref - The full path of the dataref, or a handle from find()
+     * @param out - Receives up to `out.length` elements
+     * @param offset - Start index in the dataref array (default: 0)
+     * @returns Number of elements written to `out`
+     */
+    getIntArray(dataref: DataRefKey, out: Int32Array, offset?: number): number;
 
     /**
      * Read a float array from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param offset - Start index in the array (default: 0)
      * @param count - Number of elements to read (default: all remaining)
-     * @returns Array of floats, or `null` if the dataref is not found
+     * @returns A new Float32Array, or `null` if the dataref is not found
      */
-    getFloatArray(name: string, offset?: number, count?: number): number[] | null;
+    getFloatArray(dataref: DataRefKey, offset?: number, count?: number): Float32Array | null;
+
+    /**
+     * Read a float array dataref into an existing Float32Array, without allocating
+     * 
+     * @param dataref - The full path of the dataref, or a handle from find()
+     * @param out - Receives up to `out.length` elements
+     * @param offset - Start index in the dataref array (default: 0)
+     * @returns Number of elements written to `out`
+     */
+    getFloatArray(dataref: DataRefKey, out: Float32Array, offset?: number): number;
 
     /**
      * Read byte/string data from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param offset - Start byte offset (default: 0)
      * @param maxBytes - Maximum bytes to read (default: all remaining)
      * @returns String value, or empty string if the dataref is not found
      */
-    getData(name: string, offset?: number, maxBytes?: number): string;
+    getData(dataref: DataRefKey, offset?: number, maxBytes?: number): string;
+
+    // =========================================================================
+    // Bulk Reads
+    // =========================================================================
+
+    /**
+     * Register a list of datarefs to read together with readMany()
+     * 
+     * Entries are resolved once. "path[index]" selects one element of an int or
+     * float array dataref. Defining the same list again returns the same set.
+     * 
+     * @param datarefs - Paths or handles, in output order
+     * @returns Set ID for readMany()
+     */
+    defineSet(datarefs: DataRefKey[]): DataRefSet;
+
+    /**
+     * Read every dataref of a set into a Float64Array in one call, without allocating
+     * 
+     * @param set - ID returned by defineSet()
+     * @param out - Element i receives entry i of the set, NaN while its dataref doesn't exist
+     * @returns Number of values written to `out`
+     */
+    readMany(set: DataRefSet, out: Float64Array): number;
+
+    // =========================================================================
+    // Subscriptions
+    // =========================================================================
+
+    /**
+     * Call back when a dataref changes, instead of polling it
+     * 
+     * Sampling and change detection are native. An app is called at most once per
+     * frame, only for the subscriptions that changed, and not at all while nothing
+     * changes. The first value arrives on the next frame.
+     * 
+     * @param dataref - The full path of the dataref, "path[index]", or a handle from find()
+     * @param options - Sample rate and smallest change to deliver
+     * @param callback - Called with the new value
+     * @returns Subscription ID, or 0 for an invalid handle
+     */
+    subscribe(dataref: DataRefKey, options: SubscribeOptions, callback: (value: number) => void): DataRefSubscription;
+    subscribe(dataref: DataRefKey, callback: (value: number) => void): DataRefSubscription;
+
+    /**
+     * Stop a subscription, they also end when the page reloads
+     * 
+     * @param subscription - ID returned by subscribe()
+     * @returns true if the subscription existed
+     */
+    unsubscribe(subscription: DataRefSubscription): boolean;
+
+    // =========================================================================
+    // Snapshot
+    // =========================================================================
+
+    /**
+     * Declare named datarefs that are copied into a buffer once per frame
+     * 
+     * Reads are plain typed-array loads. Datarefs declared by several apps are
+     * sampled once and copied into each buffer. The declarations last until the page reloads.
+     * 
+     * @param schema - Names mapped to paths, "path[index]" or handles from find()
+     * @returns The buffer, a Float64Array over it and the index of every name, or null if 4096 different datarefs are already declared
+     */
+    snapshot<T extends Record<string, DataRefKey>>(schema: T): DataRefSnapshot<keyof T> | null;
 
     // =========================================================================
     // Scalar Setters
@@ -184,29 +319,29 @@ interface DataRefAPI {
     /**
      * Write an integer value to a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param value - The value to set
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      */
-    setInt(name: string, value: number): boolean;
+    setInt(dataref: DataRefKey, value: number): boolean;
 
     /**
      * Write a float value to a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param value - The value to set
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      */
-    setFloat(name: string, value: number): boolean;
+    setFloat(dataref: DataRefKey, value: number): boolean;
 
     /**
      * Write a double-precision value to a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param value - The value to set
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      */
-    setDouble(name: string, value: number): boolean;
+    setDouble(dataref: DataRefKey, value: number): boolean;
 
     // =========================================================================
     // Array Setters
@@ -215,32 +350,32 @@ interface DataRefAPI {
     /**
      * Write an integer array to a dataref
      * 
-     * @param name - The full path of the dataref
-     * @param values - Array of integers to write
+     * @param dataref - The full path of the dataref, or a handle from find()
+     * @param values - Values to write, a Int32Array is passed to X-Plane without conversion
      * @param offset - Start index in the dataref array (default: 0)
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      */
-    setIntArray(name: string, values: number[], offset?: number): boolean;
+    setIntArray(dataref: DataRefKey, values: ArrayLike<number>, offset?: number): boolean;
 
     /**
      * Write a float array to a dataref
      * 
-     * @param name - The full path of the dataref
-     * @param values - Array of floats to write
+     * @param dataref - The full path of the dataref, or a handle from find()
+     * @param values - Values to write, a Float32Array is passed to X-Plane without conversion
      * @param offset - Start index in the dataref array (default: 0)
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      */
-    setFloatArray(name: string, values: number[], offset?: number): boolean;
+    setFloatArray(dataref: DataRefKey, values: ArrayLike<number>, offset?: number): boolean;
 
     /**
      * Write string/byte data to a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param value - String value to write
      * @param offset - Start byte offset in the dataref (default: 0)
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      */
-    setData(name: string, value: string, offset?: number): boolean;
+    setData(dataref: DataRefKey, value: string, offset?: number): boolean;
 }
 
 // =============================================================================
@@ -526,4 +661,38 @@ interface GraphicsAPI {
     worldToLocal(latitude: number, longitude: number, altitude: number): LocalCoordinates;
 }
 
+// =============================================================================
+// App API Types
+// =============================================================================
+
+/**
+ * App lifecycle hooks
+ * 
+ * Apps hidden for longer than their suspend delay are unloaded if they
+ * define onSuspend. The returned state is handed to the page that is loaded
+ * when the app is shown again.
+ * 
+ * @example
+ * ```typescript
+ * XPlane.app.onSuspend = () => ({ tab: currentTab });
+ * 
+ * window.addEventListener('skyscript:restore', (e) => {
+ *     const state = JSON.parse((e as CustomEvent<string>).detail);
+ * });
+ * ```
+ */
+interface AppAPI {
+    /**
+     * Set by the app: called before the page is unloaded, returns the state to keep
+     * (a string, or anything JSON.stringify accepts). Throw to stay loaded.
+     */
+    onSuspend?: () => unknown;
+
+    /**
+     * Set by SkyScript on a page reloaded after suspension: what onSuspend returned,
+     * objects as their JSON string
+     */
+    readonly restoredState?: string;
+}
+
 export {};
@@ -25,6 +25,48 @@ interface XPlaneAPI {
     dataref: DataRefAPI;
 }
 
+/**
+ * Numeric dataref handle returned by find()
+ */
+type DataRefHandle = number;
+
+/**
+ * A dataref path or a handle from find(), accepted by every getter and setter
+ */
+type DataRefKey = string | DataRefHandle;
+
+/**
+ * Dataref set ID returned by defineSet()
+ */
+type DataRefSet = number;
+
+/**
+ * Subscription ID returned by subscribe()
+ */
+type DataRefSubscription = number;
+
+/**
+ * Per-frame dataref buffer returned by snapshot()
+ */
+interface DataRefSnapshot<K extends PropertyKey = string> {
+    /** Frame counter and values, refilled once per frame */
+    buffer: ArrayBuffer;
+    /** Float64Array over buffer, values[0] is the frame counter */
+    values: Float64Array;
+    /** Index in values of every name in the schema */
+    offsets: Record<K, number>;
+}
+
+/**
+ * Sampling options for subscribe()
+ */
+interface SubscribeOptions {
+    /** Samples per second (default: every frame) */
+    hz?: number;
+    /** Changes up to this size are ignored (default: 0, any change) */
+    epsilon?: number;
+}
+
 /**
  * DataRef type information returned by getTypes()
  */
@@ -70,10 +112,12 @@ interface DataRefAPI {
     // =========================================================================
 
     /**
-     * Check if a dataref exists
+     * Look up a dataref
      * 
      * @param name - The full path of the dataref (e.g., "sim/cockpit/radios/nav1_freq_hz")
-     * @returns `true` if the dataref exists, `null` otherwise
+     * @returns A handle for the dataref, or `null` if it doesn't exist. Handles are
+     * positive numbers, so the result can still be used as a boolean. Pass the handle
+     * instead of the name to any getter or setter to skip the name lookup.
      * 
      * @example
      * ```typescript
@@ -82,7 +126,7 @@ interface DataRefAPI {
      * }
      * ```
      */
-    find(name: string): boolean | null;
+    find(name: string): DataRefHandle | null;
 
     /**
      * Check if a dataref is writable
@@ -90,7 +134,7 @@ interface DataRefAPI {
      * Note: Even writable datarefs may be overwritten by X-Plane each frame.
      * Some datarefs require setting an "override" dataref to prevent this.
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @returns `true` if writable, `false` if read-only or not found
      * 
      * @example
@@ -100,7 +144,7 @@ interface DataRefAPI {
      * }
      * ```
      */
-    canWrite(name: string): boolean;
+    canWrite(dataref: DataRefKey): boolean;
 
     /**
      * Get the supported data types for a dataref
@@ -108,7 +152,7 @@ interface DataRefAPI {
      * A dataref can support multiple types. Choose the most appropriate
      * accessor method based on the types returned.
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @returns Object with boolean flags for each supported type, or `null` if not found
      * 
      * @example
@@ -119,7 +163,7 @@ interface DataRefAPI {
      * }
      * ```
      */
-    getTypes(name: string): DataRefTypes | null;
+    getTypes(dataref: DataRefKey): DataRefTypes | null;
 
     // =========================================================================
     // Scalar Getters
@@ -128,7 +172,7 @@ interface DataRefAPI {
     /**
      * Read an integer value from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @returns The integer value, or 0 if the dataref is not found
      * 
      * @example
@@ -141,12 +185,12 @@ interface DataRefAPI {
      * const gearHandle = XPlane.dataref.getInt("sim/cockpit/switches/gear_handle_status");
      * ```
      */
-    getInt(name: string): number;
+    getInt(dataref: DataRefKey): number;
 
     /**
      * Read a float value from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @returns The float value, or 0.0 if the dataref is not found
      * 
      * @example
@@ -158,14 +202,14 @@ interface DataRefAPI {
      * const heading = XPlane.dataref.getFloat("sim/flightmodel/position/mag_psi");
      * ```
      */
-    getFloat(name: string): number;
+    getFloat(dataref: DataRefKey): number;
 
     /**
      * Read a double-precision value from a dataref
      * 
      * Use this for high-precision values like latitude/longitude.
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @returns The double value, or 0.0 if the dataref is not found
      * 
      * @example
@@ -175,7 +219,7 @@ interface DataRefAPI {
      * const lon = XPlane.dataref.getDouble("sim/flightmodel/position/longitude");
      * ```
      */
-    getDouble(name: string): number;
+    getDouble(dataref: DataRefKey): number;
 
     // =========================================================================
     // Array Getters
@@ -184,10 +228,10 @@ interface DataRefAPI {
     /**
      * Read an integer array from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param offset - Start index in the array (default: 0)
      * @param count - Number of elements to read (default: all remaining)
-     * @returns Array of integers, or `null` if the dataref is not found
+     * @returns A new Int32Array, or `null` if the dataref is not found
      * 
      * @example
      * ```typescript
@@ -198,15 +242,25 @@ interface DataRefAPI {
      * }
      * ```
      */
-    getIntArray(name: string, offset?: number, count?: number): number[] | null;
+    getIntArray(dataref: DataRefKey, offset?: number, count?: number): Int32Array | null;
+
+    /**
+     * Read an integer array dataref into an existing Int32Array, without allocating
+     * 
+     * @param dataref - The full path of the dataref, or a handle from find()
+     * @param out - Receives up to `out.length` elements
+     * @param offset - Start index in the dataref array (default: 0)
+     * @returns Number of elements written to `out`
+     */
+    getIntArray(dataref: DataRefKey, out: Int32Array, offset?: number): number;
 
     /**
      * Read a float array from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param offset - Start index in the array (default: 0)
      * @param count - Number of elements to read (default: all remaining)
-     * @returns Array of floats, or `null` if the dataref is not found
+     * @returns A new Float32Array, or `null` if the dataref is not found
      * 
      * @example
      * ```typescript
@@ -220,12 +274,22 @@ interface DataRefAPI {
      * const firstTwo = XPlane.dataref.getFloatArray("sim/cockpit2/engine/actuators/throttle_ratio", 0, 2);
      * ```
      */
-    getFloatArray(name: string, offset?: number, count?: number): number[] | null;
+    getFloatArray(dataref: DataRefKey, offset?: number, count?: number): Float32Array | null;
+
+    /**
+     * Read a float array dataref into an existing Float32Array, without allocating
+     * 
+     * @param dataref - The full path of the dataref, or a handle from find()
+     * @param out - Receives up to `out.length` elements
+     * @param offset - Start index in the dataref array (default: 0)
+     * @returns Number of elements written to `out`
+     */
+    getFloatArray(dataref: DataRefKey, out: Float32Array, offset?: number): number;
 
     /**
      * Read byte/string data from a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param offset - Start byte offset (default: 0)
      * @param maxBytes - Maximum bytes to read (default: all remaining)
      * @returns String value, or empty string if the dataref is not found
@@ -240,7 +304,97 @@ interface DataRefAPI {
      * const airport = XPlane.dataref.getData("sim/flightmodel/position/nearest_airport_id");
      * ```
      */
-    getData(name: string, offset?: number, maxBytes?: number): string;
+    getData(dataref: DataRefKey, offset?: number, maxBytes?: number): string;
+
+    // =========================================================================
+    // Bulk Reads
+    // =========================================================================
+
+    /**
+     * Register a list of datarefs to read together with readMany()
+     * 
+     * Entries are resolved once. "path[index]" selects one element of an int or
+     * float array dataref. Defining the same list again returns the same set.
+     * 
+     * @param datarefs - Paths or handles, in output order
+     * @returns Set ID for readMany()
+     */
+    defineSet(datarefs: DataRefKey[]): DataRefSet;
+
+    /**
+     * Read every dataref of a set into a Float64Array in one call, without allocating
+     * 
+     * @param set - ID returned by defineSet()
+     * @param out - Element i receives entry i of the set, NaN while its dataref doesn't exist
+     * @returns Number of values written to `out`
+     * 
+     * @example
+     * ```typescript
+     * const flight = XPlane.dataref.defineSet([
+     *     "sim/flightmodel/position/elevation",
+     *     "sim/flightmodel/position/indicated_airspeed",
+     *     "sim/cockpit2/engine/indicators/N1_percent[0]",
+     * ]);
+     * const values = new Float64Array(3);
+     * XPlane.dataref.readMany(flight, values);
+     * ```
+     */
+    readMany(set: DataRefSet, out: Float64Array): number;
+
+    // =========================================================================
+    // Subscriptions
+    // =========================================================================
+
+    /**
+     * Call back when a dataref changes, instead of polling it
+     * 
+     * Sampling and change detection are native. An app is called at most once per
+     * frame, only for the subscriptions that changed, and not at all while nothing
+     * changes. The first value arrives on the next frame.
+     * 
+     * @param dataref - The full path of the dataref, "path[index]", or a handle from find()
+     * @param options - Sample rate and smallest change to deliver
+     * @param callback - Called with the new value
+     * @returns Subscription ID, or 0 for an invalid handle
+     * 
+     * @example
+     * ```typescript
+     * XPlane.dataref.subscribe("sim/flightmodel/position/elevation", { hz: 10, epsilon: 0.3 },
+     *     meters => setAltitude(meters * 3.28084));
+     * ```
+     */
+    subscribe(dataref: DataRefKey, options: SubscribeOptions, callback: (value: number) => void): DataRefSubscription;
+    subscribe(dataref: DataRefKey, callback: (value: number) => void): DataRefSubscription;
+
+    /**
+     * Stop a subscription, they also end when the page reloads
+     * 
+     * @param subscription - ID returned by subscribe()
+     * @returns true if the subscription existed
+     */
+    unsubscribe(subscription: DataRefSubscription): boolean;
+
+    // =========================================================================
+    // Snapshot
+    // =========================================================================
+
+    /**
+     * Declare named datarefs that are copied into a buffer once per frame
+     * 
+     * Reads are plain typed-array loads. Datarefs declared by several apps are
+     * sampled once and copied into each buffer. The declarations last until the page reloads.
+     * 
+     * @param schema - Names mapped to paths, "path[index]" or handles from find()
+     * @returns The buffer, a Float64Array over it and the index of every name, or null if 4096 different datarefs are already declared
+     * 
+     * @example
+     * ```typescript
+     * const snap = XPlane.dataref.snapshot({ altitude: "sim/flightmodel/position/elevation" })!;
+     * const altitude = snap.values[snap.offsets.altitude];
+     * const frame = snap.values[0];
+     * ```
+     */
+    snapshot<T extends Record<string, DataRefKey>>(schema: T): DataRefSnapshot<keyof T> | null;
 
     // =========================================================================
     // Scalar Setters
@@ -249,7 +403,7 @@ interface DataRefAPI {
     /**
      * Write an integer value to a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param value - The value to set
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      * 
@@ -262,12 +416,12 @@ interface DataRefAPI {
      * XPlane.dataref.setInt("sim/cockpit/switches/gear_handle_status", 1);
      * ```
      */
-    setInt(name: string, value: number): boolean;
+    setInt(dataref: DataRefKey, value: number): boolean;
 
     /**
      * Write a float value to a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param value - The value to set
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      * 
@@ -280,12 +434,12 @@ interface DataRefAPI {
      * XPlane.dataref.setFloat("sim/cockpit/autopilot/heading_mag", 270);
      * ```
      */
-    setFloat(name: string, value: number): boolean;
+    setFloat(dataref: DataRefKey, value: number): boolean;
 
     /**
      * Write a double-precision value to a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param value - The value to set
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      * 
@@ -296,7 +450,7 @@ interface DataRefAPI {
      * XPlane.dataref.setDouble("sim/flightmodel/position/longitude", -122.3144);
      * ```
      */
-    setDouble(name: string, value: number): boolean;
+    setDouble(dataref: DataRefKey, value: number): boolean;
 
     // =========================================================================
     // Array Setters
@@ -305,8 +459,8 @@ interface DataRefAPI {
     /**
      * Write an integer array to a dataref
      * 
-     * @param name - The full path of the dataref
-     * @param values - Array of integers to write
+     * @param dataref - The full path of the dataref, or a handle from find()
+     * @param values - Values to write, a Int32Array is passed to X-Plane without conversion
      * @param offset - Start index in the dataref array (default: 0)
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      * 
@@ -316,13 +470,13 @@ interface DataRefAPI {
      * XPlane.dataref.setIntArray("sim/cockpit/radios/transponder_code", [7, 0, 0, 0]);
      * ```
      */
-    setIntArray(name: string, values: number[], offset?: number): boolean;
+    setIntArray(dataref: DataRefKey, values: ArrayLike<number>, offset?: number): boolean;
 
     /**
      * Write a float array to a dataref
      * 
-     * @param name - The full path of the dataref
-     * @param values - Array of floats to write
+     * @param dataref - The full path of the dataref, or a handle from find()
+     * @param values - Values to write, a Float32Array is passed to X-Plane without conversion
      * @param offset - Start index in the dataref array (default: 0)
      * @returns `true` if successful, `false` if the dataref is not found or not writable
      * 
@@ -335,12 +489,12 @@ interface DataRefAPI {
      * XPlane.dataref.setFloatArray("sim/cockpit2/engine/actuators/throttle_ratio", [0.75], 0);
      * ```
      */
-    setFloatArray(name: string, values: number[], offset?: number): boolean;
+    setFloatArray(dataref: DataRefKey, values: ArrayLike<number>, offset?: number): boolean;
 
     /**
      * Write string/byte data to a dataref
      * 
-     * @param name - The full path of the dataref
+     * @param dataref - The full path of the dataref, or a handle from find()
      * @param value - String value to write
      * @param offset - Start byte offset in the dataref (default: 0)
      * @returns `true` if successful, `false` if the dataref is not found or not writable
@@ -351,7 +505,7 @@ interface DataRefAPI {
      * XPlane.dataref.setData("sim/aircraft/view/acf_tailnum", "N12345");
      * ```
      */
-    setData(name: string, value: string, offset?: number): boolean;
+    setData(dataref: DataRefKey, value: string, offset?: number): boolean;
 }
 
 export {};
@@ -24,21 +24,24 @@ function App() {
   useEffect(() => {
     const timer = setInterval(() => {
       setTime(new Date().toLocaleTimeString());
-
-      // Read X-Plane data if available
-      if (typeof XPlane !== 'undefined') {
-        try {
-          setAltitude(XPlane.dataref.getFloat("sim/flightmodel/position/elevation") * 3.28084); // meters to feet
-          setAirspeed(XPlane.dataref.getFloat("sim/flightmodel/position/indicated_airspeed"));
-          setHeading(XPlane.dataref.getFloat("sim/flightmodel/position/mag_psi"));
-        } catch (e) {
-          console.log("Error reading datarefs:", e);
-        }
-      }
     }, 1000);
     return () => clearInterval(timer);
   }, []);
 
+  // X-Plane calls back only when a value changes, nothing runs while the aircraft sits still
+  useEffect(() => {
+    if (typeof XPlane === 'undefined') {
+      return;
+    }
+    const subscriptions = [
+      XPlane.dataref.subscribe("sim/flightmodel/position/elevation", { hz: 10, epsilon: 0.3 },
+        meters => setAltitude(meters * 3.28084)), // meters to feet
+      XPlane.dataref.subscribe("sim/flightmodel/position/indicated_airspeed", { hz: 10, epsilon: 0.1 }, setAirspeed),
+      XPlane.dataref.subscribe("sim/flightmodel/position/mag_psi", { hz: 10, epsilon: 0.1 }, setHeading),
+    ];
+    return () => subscriptions.forEach(id => XPlane.dataref.unsubscribe(id));
+  }, []);
+
   // Clean up object on unmount
   useEffect(() => {
     return () => {
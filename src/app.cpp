@@ -1,6 +1,10 @@
 #include "app.h"
 #include "js_bindings.h"
+#include "manager.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <fstream>
 #include <cstring>
 #include <vector>
@@ -8,6 +12,17 @@
 // Set to 1 to enable debug logging and screenshot saving
 #define DEBUG_DRAW 0
 
+// A window counts as focused this long after the last mouse or keyboard input
+static const double kFocusLinger = 2.0;
+
+// Render scale limits, auto mode moves between 1.0 and kMinAutoScale in kScaleStep steps
+static const double kMinRenderScale = 0.25;
+static const double kMinAutoScale = 0.5;
+static const double kScaleStep = 0.25;
+
+// Auto render scale waits this long between changes so the raster average can settle
+static const double kScaleHoldTime = 1.0;
+
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
@@ -16,15 +31,24 @@ App::App() : app_name(""), app_dir("") {}
 App::App(const std::string &name, const std::string &dir)
     : app_name(name), app_dir(dir)
 {
+    manifest_.Load(app_dir);
+    max_fps_focused_ = manifest_.GetNumber("fps.focused", 0.0);
+    max_fps_unfocused_ = manifest_.GetNumber("fps.unfocused", max_fps_focused_);
+
+    // "renderScale": 0.5 renders at half resolution, "auto" scales down while rasterizing is slow
+    auto_scale_ = manifest_.GetString("renderScale", "") == "auto";
+    if (!auto_scale_)
+        render_scale_ = std::clamp(manifest_.GetNumber("renderScale", 1.0), kMinRenderScale, 1.0);
+    raster_budget_ = manifest_.GetNumber("renderBudgetMs", 4.0) / 1000.0;
+
+    // "suspend": true lets apps without an onSuspend hook be suspended, "suspendAfter" overrides the manager's delay
+    suspend_opt_in_ = manifest_.GetBool("suspend", false);
+    suspend_after_ = manifest_.GetNumber("suspendAfter", -1.0);
     LogMsg("App created: %s, dir: %s", app_name.c_str(), app_dir.c_str());
 }
 
 App::~App()
 {
-    if (texture_id_ != 0)
-    {
-        glDeleteTextures(1, &texture_id_);
-    }
 }
 
 void App::ForceRepaint()
@@ -35,51 +59,79 @@ void App::ForceRepaint()
     }
 }
 
-void App::UpdateTexture()
+double App::Now()
 {
-    if (!main_view_)
-        return;
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
 
-    // Get the rendered surface from Ultralight
-    Surface *surface = main_view_->surface();
-    if (!surface)
-        return;
+void App::NoteInput()
+{
+    last_input_time_ = Now();
+    RequestRepaint();
+}
 
-    BitmapSurface *bitmap_surface = static_cast<BitmapSurface *>(surface);
-    RefPtr<Bitmap> bitmap = bitmap_surface->bitmap();
+bool App::IsFocused(double now) const
+{
+    if (main_window_ && XPLMHasKeyboardFocus(main_window_))
+        return true;
+    return last_input_time_ >= 0.0 && now - last_input_time_ < kFocusLinger;
+}
 
-    if (!bitmap || bitmap->IsEmpty())
-        return;
+bool App::SchedulePaint(const RenderPacing &pacing)
+{
+    if (!main_view_)
+        return false;
 
-    // Create texture if needed
-    if (texture_id_ == 0)
-    {
-        glGenTextures(1, &texture_id_);
-        glBindTexture(GL_TEXTURE_2D, texture_id_);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-        // Force initial texture upload
-        void *pixels = bitmap->LockPixels();
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bitmap->width(), bitmap->height(),
-                     0, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        bitmap->UnlockPixels();
-        bitmap_surface->ClearDirtyBounds();
-        texture_needs_init_ = false;
+    if (repaint_requested_)
+    {
+        main_view_->set_needs_paint(true);
+        repaint_requested_ = false;
     }
 
-    // Upload bitmap to texture if dirty
-    if (bitmap_surface->dirty_bounds().IsEmpty() == false)
+    if (!main_view_->needs_paint())
+        return false;
+
+    // Too early for this app, the view stays dirty and the last texture keeps being drawn
+    double max_fps = GetMaxFps(IsFocused(pacing.now));
+    if (throttle_ > 0)
     {
-        glBindTexture(GL_TEXTURE_2D, texture_id_);
-        void *pixels = bitmap->LockPixels();
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bitmap->width(), bitmap->height(),
-                     0, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
-        bitmap->UnlockPixels();
-        bitmap_surface->ClearDirtyBounds();
+        double cap = Watchdog::ThrottleFps(throttle_);
+        max_fps = max_fps > 0.0 ? std::min(max_fps, cap) : cap;
     }
+    double interval = max_fps > 0.0 ? 1.0 / max_fps : pacing.frame_period;
+    if (pacing.rate_scale < 1.0)
+        interval /= pacing.rate_scale;
+    else if (max_fps <= 0.0)
+        interval = 0.0;
+
+    // Half a frame of slack so a 30 fps cap at 60 fps sim doesn't drift to 20 fps
+    if (last_render_time_ >= 0.0 && pacing.now - last_render_time_ < interval - pacing.frame_period * 0.5)
+        return false;
+
+    // The next Render() paints straight into the upload buffer. While the GPU is still
+    // copying out of it, the view stays dirty and is painted on a later frame.
+    if (!accelerated_ && UploadSurfaceFactory::instance().IsInstalled())
+    {
+        UploadSurface *surface = static_cast<UploadSurface *>(main_view_->surface());
+        if (surface && !surface->IsUploadComplete())
+            return false;
+    }
+    last_render_time_ = pacing.now;
+    return true;
+}
+
+size_t App::UpdateTexture()
+{
+    // Accelerated views render straight into their GPU texture
+    if (!main_view_ || accelerated_)
+        return 0;
+
+    // Upload only the dirty rectangle of the rendered surface
+    Surface *surface = main_view_->surface();
+    if (UploadSurfaceFactory::instance().IsInstalled())
+        return uploader_.Upload(static_cast<UploadSurface *>(surface));
+    return uploader_.Upload(surface);
 }
 
 void App::Draw()
@@ -87,13 +139,18 @@ void App::Draw()
     if (!main_view_ || !main_window_)
         return;
 
-    // Check if window was resized
-    CheckResize();
-
-    // Ensure texture is up to date
-    UpdateTexture();
+    // Accelerated views are sampled from their render target, which may be padded.
+    // Pooled textures are rounded up in size, the view sits in the top-left corner.
+    GLuint texture = uploader_.texture();
+    Rect uv = uploader_.uv();
+    if (accelerated_)
+    {
+        RenderTarget target = main_view_->render_target();
+        texture = target.is_empty ? 0 : GPUDriverGL::instance().GetGLTexture(target.texture_id);
+        uv = target.uv_coords;
+    }
 
-    if (texture_id_ == 0)
+    if (texture == 0)
         return;
 
     // Get window geometry
@@ -110,42 +167,66 @@ void App::Draw()
         0  // No depth write
     );
 
-    XPLMBindTexture2d(texture_id_, 0);
+    XPLMBindTexture2d(texture, 0);
 
     glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
     glBegin(GL_QUADS);
     // Note: Ultralight renders top-down, OpenGL is bottom-up
     // Flip V coordinates: use 0 at top, 1 at bottom
-    glTexCoord2f(0.0f, 0.0f);
+    glTexCoord2f(uv.left, uv.top);
     glVertex2f(left, top);
-    glTexCoord2f(1.0f, 0.0f);
+    glTexCoord2f(uv.right, uv.top);
     glVertex2f(right, top);
-    glTexCoord2f(1.0f, 1.0f);
+    glTexCoord2f(uv.right, uv.bottom);
     glVertex2f(right, bottom);
-    glTexCoord2f(0.0f, 1.0f);
+    glTexCoord2f(uv.left, uv.bottom);
     glVertex2f(left, bottom);
     glEnd();
 }
 
+size_t App::GetBitmapBytes() const
+{
+    if (!main_view_)
+        return 0;
+    if (accelerated_)
+    {
+        RenderTarget target = main_view_->render_target();
+        return target.is_empty ? 0 : static_cast<size_t>(target.texture_width) * target.texture_height * 4;
+    }
+    Surface *surface = main_view_->surface();
+    return surface ? surface->size() : 0;
+}
+
+size_t App::GetTextureBytes() const
+{
+    return static_cast<size_t>(uploader_.storage_width()) * uploader_.storage_height() * 4;
+}
+
+bool App::ReleaseGraphics()
+{
+    if (uploader_.texture() == 0)
+        return false;
+
+    // The next upload after Show() reallocates and sends the whole surface
+    uploader_.Reset();
+    return true;
+}
+
 void App::Initialize(RefPtr<Renderer> renderer)
 {
     LogMsg("Initializing app: %s", app_name.c_str());
 
-    // create a view for this app with actual dimensions
-    view_width_ = 800;
-    view_height_ = 600;
-    main_view_ = renderer->CreateView(view_width_, view_height_, ViewConfig(), nullptr);
-    main_view_->set_view_listener(this);
-    main_view_->set_load_listener(this);
+    // create a view for this app with actual dimensions, or the window size before Shutdown()
+    view_width_ = has_snapshot_ ? snapshot_right_ - snapshot_left_ : 800;
+    view_height_ = has_snapshot_ ? snapshot_top_ - snapshot_bottom_ : 600;
 
-    // Note: JS bindings are set up in OnDOMReady after the page loads
+    renderer_ = renderer;
+    accelerated_ = manifest_.GetBool("accelerated", false) && GPUDriverGL::instance().IsInstalled();
+    LogMsg("[%s] %s rendering", app_name.c_str(), accelerated_ ? "GPU" : "CPU");
+    if (render_scale_ < 1.0 || auto_scale_)
+        LogMsg("[%s] Render scale %.2f%s", app_name.c_str(), render_scale_, auto_scale_ ? " (auto)" : "");
 
-    // Load index.html using Ultralight's FileSystem (configured with plugin_dir as base)
-    // Path is relative to plugin_dir, e.g., "apps/app_manager/index.html"
-    std::string relative_path = "apps/" + app_name + "/index.html";
-    std::string file_url = "file:///" + relative_path;
-    LogMsg("Loading URL: %s", file_url.c_str());
-    main_view_->LoadURL(file_url.c_str());
+    CreateMainView();
 
     int winLeft, winTop, winRight, winBot;
     XPLMGetScreenBoundsGlobal(&winLeft, &winTop, &winRight, &winBot);
@@ -164,7 +245,7 @@ void App::Initialize(RefPtr<Renderer> renderer)
         App *app = static_cast<App *>(refcon);
         if (app)
         {
-            app->Draw();
+            Manager::instance().drawApp(*app);
         }
     };
     params.handleMouseClickFunc = [](XPLMWindowID wnd, int x, int y, int isDown, void *refcon) -> int
@@ -199,6 +280,7 @@ void App::Initialize(RefPtr<Renderer> renderer)
             evt.delta_x = 0;
             evt.delta_y = clicks * 30;  // Scroll amount
             app->main_view_->FireScrollEvent(evt);
+            app->NoteInput();
             return 1;
         }
         return 0;
@@ -227,14 +309,229 @@ void App::Initialize(RefPtr<Renderer> renderer)
     XPLMSetWindowTitle(main_window_, app_name.c_str());
     XPLMSetWindowResizingLimits(main_window_, 200, 200, 2000, 2000);  // Allow resizing
     XPLMSetWindowIsVisible(main_window_, 0);  // Hidden by default - use menu to show
+    hidden_since_ = Now();
+
+    // Back from Shutdown(): same place, same visibility, the page gets its state in OnDOMReady
+    if (has_snapshot_)
+    {
+        XPLMSetWindowGeometry(main_window_, snapshot_left_, snapshot_top_, snapshot_right_, snapshot_bottom_);
+        if (snapshot_visible_)
+            Show();
+        has_snapshot_ = false;
+    }
+}
+
+void App::CreateMainView()
+{
+    // "skyscript": { "accelerated": true } in manifest.json opts into GPU rendering
+    ViewConfig view_config;
+    view_config.is_accelerated = accelerated_;
+
+    // Reduced render scale keeps the CSS layout size and rasterizes fewer pixels
+    view_config.initial_device_scale = render_scale_;
+
+    main_view_ = renderer_->CreateView(ScaledSize(view_width_), ScaledSize(view_height_), view_config, nullptr);
+    main_view_->set_view_listener(this);
+    main_view_->set_load_listener(this);
+
+    // Note: JS bindings are set up in OnDOMReady after the page loads
+
+    // Load index.html using Ultralight's FileSystem (configured with plugin_dir as base)
+    // Path is relative to plugin_dir, e.g., "apps/app_manager/index.html"
+    std::string relative_path = "apps/" + app_name + "/index.html";
+    std::string file_url = "file:///" + relative_path;
+    LogMsg("Loading URL: %s", file_url.c_str());
+    main_view_->LoadURL(file_url.c_str());
+    RequestRepaint();
+}
+
+bool App::HasSuspendHook()
+{
+    String exception;
+    String result = main_view_->EvaluateScript(
+        "typeof XPlane !== 'undefined' && !!XPlane.app && typeof XPlane.app.onSuspend === 'function'", &exception);
+    return exception.empty() && result == "true";
+}
+
+bool App::ShouldSuspend(double now, double default_after)
+{
+    if (suspended_ || suspend_checked_ || !main_view_ || hidden_since_ < 0.0 || IsVisible())
+        return false;
+
+    double after = suspend_after_ >= 0.0 ? suspend_after_ : default_after;
+    if (after <= 0.0 || now - hidden_since_ < after)
+        return false;
+
+    // Ask the page once per hide, it opts in by defining XPlane.app.onSuspend
+    suspend_checked_ = true;
+    return suspend_opt_in_ || HasSuspendHook();
+}
+
+bool App::Suspend()
+{
+    if (suspended_ || !main_view_)
+        return false;
+
+    if (!SaveState())
+    {
+        LogMsg("[%s] onSuspend threw, staying live", app_name.c_str());
+        return false;
+    }
+
+    LogMsg("[%s] Suspended after %.0f s hidden, %zu bytes of state", app_name.c_str(),
+           Now() - hidden_since_, saved_state_.size());
+
+    ReleaseView();
+    suspended_ = true;
+    return true;
+}
+
+bool App::SaveState()
+{
+    has_saved_state_ = false;
+    saved_state_.clear();
+    if (!HasSuspendHook())
+        return true;
+
+    String exception;
+    String state = main_view_->EvaluateScript(
+        "(function () { var s = XPlane.app.onSuspend(); "
+        "return s === undefined ? undefined : (typeof s === 'string' ? s : JSON.stringify(s)); })()",
+        &exception);
+    if (!exception.empty())
+    {
+        LogMsg("[%s] onSuspend: %s", app_name.c_str(), exception.utf8().data());
+        return false;
+    }
+    if (state != "undefined")
+    {
+        saved_state_ = state.utf8().data();
+        has_saved_state_ = true;
+    }
+    return true;
+}
+
+void App::ReleaseView()
+{
+    // Dropping the last reference destroys the page, its JS heap and timers
+    if (main_view_)
+    {
+        JSBindings::UnbindView(main_view_.get());
+        main_view_->set_view_listener(nullptr);
+        main_view_->set_load_listener(nullptr);
+        main_view_ = nullptr;
+    }
+    uploader_.Reset();
+    last_render_time_ = -1.0;
+}
+
+bool App::Shutdown()
+{
+    if (!main_window_)
+        return false;
+
+    // A suspended app already saved its state, a live one is asked now
+    if (main_view_ && !SaveState())
+        LogMsg("[%s] Shutting down without state", app_name.c_str());
+
+    XPLMGetWindowGeometry(main_window_, &snapshot_left_, &snapshot_top_, &snapshot_right_, &snapshot_bottom_);
+    snapshot_visible_ = IsVisible();
+    has_snapshot_ = true;
+
+    ReleaseView();
+    XPLMDestroyWindow(main_window_);
+    main_window_ = nullptr;
+    suspended_ = false;
+    suspend_checked_ = false;
+    resize_pending_ = false;
+    hidden_since_ = -1.0;
+
+    LogMsg("[%s] Shut down, %zu bytes of state", app_name.c_str(), saved_state_.size());
+    return snapshot_visible_;
+}
+
+void App::Resume()
+{
+    if (!suspended_ || !renderer_)
+        return;
+
+    LogMsg("[%s] Resuming", app_name.c_str());
+    suspended_ = false;
+    CreateMainView();
+}
+
+double App::TakeScriptTime()
+{
+    double seconds = script_time_;
+    script_time_ = 0.0;
+    return seconds;
+}
+
+void App::SetThrottle(int level)
+{
+    if (level == throttle_)
+        return;
+    throttle_ = level;
+    if (!main_view_)
+        return;
+
+    std::string script = "window.__skyscriptSetTimerFloor && __skyscriptSetTimerFloor(" +
+                         std::to_string(Watchdog::ThrottleTimerFloor(level)) + ")";
+    main_view_->EvaluateScript(script.c_str());
+}
+
+void App::Reload(bool discard_state)
+{
+    // State saved for the previous aircraft doesn't carry over
+    if (discard_state)
+    {
+        has_saved_state_ = false;
+        saved_state_.clear();
+    }
+    if (!main_view_)
+        return;
+
+    LogMsg("[%s] Reloading", app_name.c_str());
+    JSBindings::UnbindView(main_view_.get());
+    main_view_->Reload();
+    last_render_time_ = -1.0;
+    RequestRepaint();
+}
+
+void App::RestoreState()
+{
+    if (!has_saved_state_ || !main_view_)
+        return;
+
+    RefPtr<JSContext> context = main_view_->LockJSContext();
+    SetJSContext(context->ctx());
+    JSObject global = JSGlobalObject();
+    JSValue xplane = global["XPlane"];
+    if (xplane.IsObject())
+    {
+        JSValue app = xplane.ToObject()["app"];
+        if (app.IsObject())
+        {
+            JSObject app_object = app.ToObject();
+            app_object["restoredState"] = JSValue(String(saved_state_.c_str()));
+        }
+    }
+    JSEval("window.dispatchEvent(new CustomEvent('skyscript:restore', { detail: XPlane.app.restoredState }))");
+
+    has_saved_state_ = false;
+    saved_state_.clear();
 }
 
 void App::Show()
 {
     if (main_window_)
     {
+        Resume();
+        hidden_since_ = -1.0;
+        suspend_checked_ = false;
         XPLMSetWindowIsVisible(main_window_, 1);
         XPLMBringWindowToFront(main_window_);
+        RequestRepaint();
     }
 }
 
@@ -243,6 +540,8 @@ void App::Hide()
     if (main_window_)
     {
         XPLMSetWindowIsVisible(main_window_, 0);
+        if (hidden_since_ < 0.0)
+            hidden_since_ = Now();
     }
 }
 
@@ -271,40 +570,116 @@ void App::CheckResize()
     if (!main_view_ || !main_window_)
         return;
 
-    // Only check every 10 frames to reduce overhead
-    static int frame_skip = 0;
-    if (++frame_skip < 10)
-        return;
-    frame_skip = 0;
-
     // Get current window dimensions
     int left, top, right, bottom;
     XPLMGetWindowGeometry(main_window_, &left, &top, &right, &bottom);
     
     int new_width = right - left;
     int new_height = top - bottom;
+    if (new_width <= 0 || new_height <= 0)
+        return;
+
+    if (new_width == view_width_ && new_height == view_height_)
+    {
+        resize_pending_ = false;
+        return;
+    }
+
+    // Still being dragged: Draw() stretches the last frame over the window
+    double now = Now();
+    if (!resize_pending_ || new_width != pending_width_ || new_height != pending_height_)
+    {
+        resize_pending_ = true;
+        pending_width_ = new_width;
+        pending_height_ = new_height;
+        resize_changed_time_ = now;
+        return;
+    }
+    if (now - resize_changed_time_ < kResizeSettle)
+        return;
+
+    LogMsg("[%s] Window resized: %dx%d -> %dx%d", 
+           app_name.c_str(), view_width_, view_height_, new_width, new_height);
     
-    // Check if size changed
-    if (new_width != view_width_ || new_height != view_height_)
-    {
-        LogMsg("[%s] Window resized: %dx%d -> %dx%d", 
-               app_name.c_str(), view_width_, view_height_, new_width, new_height);
-        
-        view_width_ = new_width;
-        view_height_ = new_height;
-        
-        // Resize the Ultralight view
-        main_view_->Resize(view_width_, view_height_);
-        
-        // Delete old texture so a new one is created with correct size
-        if (texture_id_ != 0)
-        {
-            glDeleteTextures(1, &texture_id_);
-            texture_id_ = 0;
-        }
+    view_width_ = new_width;
+    view_height_ = new_height;
+    resize_pending_ = false;
+    
+    // Relayout once, the texture is swapped on the next upload only if the size leaves its pool bucket
+    main_view_->Resize(ScaledSize(view_width_), ScaledSize(view_height_));
+    RequestRepaint();
+}
+
+uint32_t App::ScaledSize(int size) const
+{
+    return static_cast<uint32_t>(std::max(1L, std::lround(size * render_scale_)));
+}
+
+void App::SetRenderScale(double scale)
+{
+    scale = std::clamp(scale, kMinRenderScale, 1.0);
+    if (scale == render_scale_)
+        return;
+
+    LogMsg("[%s] Render scale %.2f -> %.2f", app_name.c_str(), render_scale_, scale);
+    render_scale_ = scale;
+    raster_avg_ = 0.0;
+    if (!main_view_)
+        return;
+
+    // Same layout size in CSS pixels, fewer device pixels
+    main_view_->set_device_scale(render_scale_);
+    main_view_->Resize(ScaledSize(view_width_), ScaledSize(view_height_));
+    RequestRepaint();
+}
+
+void App::NoteRasterTime(double seconds, double now)
+{
+    raster_avg_ = raster_avg_ > 0.0 ? raster_avg_ * 0.8 + seconds * 0.2 : seconds;
+    if (!auto_scale_ || raster_budget_ <= 0.0)
+        return;
+    if (last_scale_change_ >= 0.0 && now - last_scale_change_ < kScaleHoldTime)
+        return;
+
+    // Raster time follows the pixel count, step back up only if the larger scale would fit too
+    double next = 0.0;
+    if (raster_avg_ > raster_budget_ && render_scale_ > kMinAutoScale)
+    {
+        next = std::max(kMinAutoScale, render_scale_ - kScaleStep);
+    }
+    else if (render_scale_ < 1.0)
+    {
+        double up = std::min(1.0, render_scale_ + kScaleStep);
+        double ratio = up / render_scale_;
+        if (raster_avg_ * ratio * ratio < raster_budget_ * 0.8)
+            next = up;
+    }
+
+    if (next > 0.0)
+    {
+        SetRenderScale(next);
+        last_scale_change_ = now;
     }
 }
 
+void App::WindowToView(int x, int y, int &view_x, int &view_y) const
+{
+    int left, top, right, bottom;
+    XPLMGetWindowGeometry(main_window_, &left, &top, &right, &bottom);
+
+    // X-Plane: origin bottom-left, Y increases upward
+    // Ultralight: origin top-left, Y increases downward
+    view_x = x - left;
+    view_y = top - y;
+
+    // Mouse events are in CSS pixels, which only differ from the window while a resize is pending
+    int width = right - left, height = top - bottom;
+    if (width > 0 && width != view_width_)
+        view_x = view_x * view_width_ / width;
+    if (height > 0 && height != view_height_)
+        view_y = view_y * view_height_ / height;
+}
+
 int App::OnMouseClick(int x, int y, int button, int mouseStatus)
 {
     if (!main_view_ || !main_window_)
@@ -326,16 +701,9 @@ int App::OnMouseClick(int x, int y, int button, int mouseStatus)
         main_view_->Focus();
     }
 
-    // Get window geometry to convert coordinates
-    int left, top, right, bottom;
-    XPLMGetWindowGeometry(main_window_, &left, &top, &right, &bottom);
-
     // Convert X-Plane coordinates to view coordinates
-    // X-Plane: origin bottom-left, Y increases upward
-    // Ultralight: origin top-left, Y increases downward
-    int view_x = x - left;
-    int view_y = y - bottom;  // Convert to window-relative, Y from bottom
-    view_y = (top - bottom) - view_y;  // Flip to top-down for Ultralight
+    int view_x, view_y;
+    WindowToView(x, y, view_x, view_y);
 
     ultralight::MouseEvent evt;
     evt.x = view_x;
@@ -359,6 +727,7 @@ int App::OnMouseClick(int x, int y, int button, int mouseStatus)
         main_view_->FireMouseEvent(evt);
     }
 
+    NoteInput();
     return 1;
 }
 
@@ -367,14 +736,15 @@ int App::OnMouseMove(int x, int y)
     if (!main_view_ || !main_window_)
         return 0;
 
-    // Get window geometry to convert coordinates
-    int left, top, right, bottom;
-    XPLMGetWindowGeometry(main_window_, &left, &top, &right, &bottom);
-
     // Convert X-Plane coordinates to view coordinates (same as OnMouseClick)
-    int view_x = x - left;
-    int view_y = y - bottom;
-    view_y = (top - bottom) - view_y;  // Flip to top-down for Ultralight
+    int view_x, view_y;
+    WindowToView(x, y, view_x, view_y);
+
+    // The cursor callback fires every frame while hovering, only forward real moves
+    if (view_x == last_mouse_x_ && view_y == last_mouse_y_)
+        return 1;
+    last_mouse_x_ = view_x;
+    last_mouse_y_ = view_y;
 
     ultralight::MouseEvent evt;
     evt.type = ultralight::MouseEvent::kType_MouseMoved;
@@ -383,6 +753,7 @@ int App::OnMouseMove(int x, int y)
     evt.button = ultralight::MouseEvent::kButton_None;
 
     main_view_->FireMouseEvent(evt);
+    NoteInput();
     return 1;
 }
 
@@ -394,9 +765,12 @@ void App::OnKey(char key, XPLMKeyFlags flags, char virtualKey, int losingFocus)
     if (losingFocus)
     {
         main_view_->Unfocus();
+        NoteInput();
         return;
     }
 
+    NoteInput();
+
     // Determine if this is a key down or key up
     bool isDown = (flags & xplm_DownFlag) != 0;
 
@@ -484,5 +858,26 @@ void App::OnDOMReady(View *caller, uint64_t frame_id, bool is_main_frame, const
     if (is_main_frame && main_view_) {
         LogMsg("[%s] Binding XPlane API to JavaScript context", app_name.c_str());
         JSBindings::BindToView(main_view_);
+        RestoreState();
     }
-}
\ No newline at end of file
+}
+
+void App::OnWindowObjectReady(View *caller, [[maybe_unused]] uint64_t frame_id, bool is_main_frame, [[maybe_unused]] const String &url)
+{
+    // Before any page script runs: time timer and animation frame callbacks for the watchdog
+    if (!is_main_frame)
+        return;
+
+    RefPtr<JSContext> context = caller->LockJSContext();
+    SetJSContext(context->ctx());
+    JSObject global = JSGlobalObject();
+    global["__skyscriptReport"] = JSCallback([this](const JSObject &, const JSArgs &args) {
+        if (args.size() > 0 && args[0].IsNumber())
+            script_time_ += args[0].ToNumber() / 1000.0;
+    });
+
+    std::string script = std::string(Watchdog::kScriptShim) + "(window.__skyscriptReport); delete window.__skyscriptReport;";
+    if (throttle_ > 0)
+        script += " __skyscriptSetTimerFloor(" + std::to_string(Watchdog::ThrottleTimerFloor(throttle_)) + ");";
+    JSEval(script.c_str());
+}
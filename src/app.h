@@ -1,8 +1,15 @@
+#pragma once
 
 #include <string>
 
 #include "log_msg.h"
 #include "js_bindings.h"
+#include "app_manifest.h"
+#include "gl_ext.h"
+#include "gpu_driver_gl.h"
+#include "texture_uploader.h"
+#include "upload_surface.h"
+#include "watchdog.h"
 
 #include <Ultralight/Ultralight.h>
 #include <JavaScriptCore/JavaScript.h>
@@ -16,22 +23,16 @@
 #include <XPLMGraphics.h>
 #include <XPLMMenus.h>
 
-#if APL
-#include <OpenGL/gl.h>
-#elif LIN || IBM
-#include <GL/gl.h>
-#endif
-
-// Windows gl.h doesn't include these OpenGL 1.2+ constants
-#ifndef GL_CLAMP_TO_EDGE
-#define GL_CLAMP_TO_EDGE 0x812F
-#endif
-#ifndef GL_BGRA
-#define GL_BGRA 0x80E1
-#endif
-
 using namespace ultralight;
 
+// Per-frame render pacing decided by the manager
+struct RenderPacing
+{
+    double now = 0.0;           // App::Now() at the start of the frame
+    double frame_period = 0.0;  // last sim frame time in seconds
+    double rate_scale = 1.0;    // adaptive throttle, 1 = render at the app's full rate
+};
+
 class App : public ultralight::ViewListener, public ultralight::LoadListener
 {
 public:
@@ -44,8 +45,13 @@ public:
     App &operator=(const App &) = delete;
 
     void Initialize(RefPtr<Renderer> renderer);
-    void UpdateTexture();  // Update texture from Ultralight bitmap
-    void Draw();
+    bool IsInitialized() const { return main_window_ != nullptr; }
+
+    // "preload": true in the manifest warms the app up in the background after aircraft load
+    bool WantsPreload() const { return manifest_.GetBool("preload", false); }
+    size_t UpdateTexture();  // Upload dirty region of the Ultralight bitmap, returns bytes sent
+
+    void Draw();  // from the window's draw callback, through Manager::drawApp()
     
     // Window visibility
     void Show();
@@ -55,15 +61,69 @@ public:
     
     // Getters
     const std::string& GetName() const { return app_name; }
+    View *GetView() const { return main_view_.get(); }
+
+    // Memory held for this app's window, see MemoryManager
+    size_t GetBitmapBytes() const;
+    size_t GetTextureBytes() const;
+
+    // Give the upload texture back to the pool while hidden, returns true if there was one
+    bool ReleaseGraphics();
+    
+    // Suspension: a long-hidden app drops its view, JS heap and texture, Show() brings it back.
+    // The page opts in with XPlane.app.onSuspend, whose return value is handed back to the
+    // reloaded page as XPlane.app.restoredState and a "skyscript:restore" event.
+    bool IsSuspended() const { return suspended_; }
+    bool ShouldSuspend(double now, double default_after);
+    bool Suspend();
+
+    // Destroy the view, texture and window but remember the window and page state,
+    // the next Initialize() brings the app back as it was. Returns true if the window was visible.
+    bool Shutdown();
+
+    // Soft reload: re-run the page scripts in the existing view and window. A suspended app
+    // keeps the state it saved unless discard_state (the aircraft changed).
+    void Reload(bool discard_state);
     
     // Force the view to repaint
     void ForceRepaint();
+
+    // Ask for a repaint on the next frame (resize, input, show)
+    void RequestRepaint() { repaint_requested_ = true; }
+
+    // Apply pending repaint requests, returns true if the view needs painting
+    // and its frame-rate cap allows a render this frame
+    bool SchedulePaint(const RenderPacing &pacing);
+
+    // Focused windows have keyboard focus or received input recently
+    bool IsFocused(double now) const;
+
+    // Monotonic seconds used for render pacing (XPLMGetElapsedTime is too coarse)
+    static double Now();
+
+    // Device pixels per CSS pixel, below 1 the view is rendered smaller and stretched over the window
+    void SetRenderScale(double scale);
+    bool IsAutoRenderScale() const { return auto_scale_; }
+
+    // Feed one Render() time for this view, auto mode adjusts the render scale from the average
+    void NoteRasterTime(double seconds, double now);
+
+    // Render rate caps from the manifest ("fps": {"focused": 60, "unfocused": 10}), 0 = uncapped
+    double GetMaxFps(bool focused) const { return focused ? max_fps_focused_ : max_fps_unfocused_; }
+
+    // Watchdog: seconds spent in the page's timer and animation frame callbacks since the last call,
+    // and the throttle level that caps its timers and render rate (see Watchdog)
+    double TakeScriptTime();
+    void SetThrottle(int level);
     
     // Mouse event handlers
     int OnMouseClick(int x, int y, int button, int mouseStatus);
     int OnMouseMove(int x, int y);
     void OnKey(char key, XPLMKeyFlags flags, char virtualKey, int losingFocus);
+
+    // Relayout the view once the window size has been stable for kResizeSettle seconds
     void CheckResize();
+    static constexpr double kResizeSettle = 0.15;
 
     // LoadListener overrides
     virtual void OnAddConsoleMessage(View *caller, const ConsoleMessage &msg) override;
@@ -71,14 +131,62 @@ public:
     virtual void OnFinishLoading(View *caller, uint64_t frame_id, bool is_main_frame, const String &url) override;
     virtual void OnFailLoading(View *caller, uint64_t frame_id, bool is_main_frame, const String &url, const String &description, const String &error_domain, int error_code) override;
     virtual void OnDOMReady(View *caller, uint64_t frame_id, bool is_main_frame, const String &url) override;
+    virtual void OnWindowObjectReady(View *caller, [[maybe_unused]] uint64_t frame_id, bool is_main_frame, [[maybe_unused]] const String &url) override;
 
 private:
+    // User interaction: repaint now and count the window as focused for a while
+    void NoteInput();
+
+    // Create the view and load the app, used by Initialize() and Resume()
+    void CreateMainView();
+    void Resume();
+    bool HasSuspendHook();
+    bool SaveState();     // ask onSuspend for the state to keep, false if it threw
+    void ReleaseView();   // drop the view and give the texture back
+    void RestoreState();  // after BindToView, if Suspend() saved something
+
+    // View size in device pixels for a size in CSS pixels
+    uint32_t ScaledSize(int size) const;
+
+    // X-Plane screen coordinates to view (CSS) coordinates, scaled while a resize is pending
+    void WindowToView(int x, int y, int &view_x, int &view_y) const;
+
     std::string app_name;
     std::string app_dir;
+    AppManifest manifest_;
+    bool accelerated_ = false;
+    RefPtr<Renderer> renderer_;
     RefPtr<View> main_view_;
     XPLMWindowID main_window_ = nullptr;
-    GLuint texture_id_ = 0;
-    int view_width_ = 800;
+    TextureUploader uploader_;
+    int view_width_ = 800;   // layout size in CSS pixels, the window size after the last resize
     int view_height_ = 600;
-    bool texture_needs_init_ = true;
+    double render_scale_ = 1.0;
+    bool auto_scale_ = false;
+    double raster_budget_ = 0.004;  // seconds per Render() before auto mode scales down
+    double raster_avg_ = 0.0;
+    double last_scale_change_ = -1.0;
+    bool suspended_ = false;
+    bool suspend_opt_in_ = false;
+    bool suspend_checked_ = false;  // asked the page since it was hidden
+    double suspend_after_ = -1.0;   // seconds hidden before suspending, < 0 = manager default
+    double hidden_since_ = -1.0;
+    bool has_saved_state_ = false;
+    std::string saved_state_;
+    bool has_snapshot_ = false;  // window saved by Shutdown()
+    bool snapshot_visible_ = false;
+    int snapshot_left_ = 0, snapshot_top_ = 0, snapshot_right_ = 0, snapshot_bottom_ = 0;
+    bool resize_pending_ = false;
+    int pending_width_ = 0;
+    int pending_height_ = 0;
+    double resize_changed_time_ = 0.0;
+    bool repaint_requested_ = true;
+    double script_time_ = 0.0;
+    int throttle_ = 0;
+    double max_fps_focused_ = 0.0;
+    double max_fps_unfocused_ = 0.0;
+    double last_render_time_ = -1.0;
+    double last_input_time_ = -1.0;
+    int last_mouse_x_ = -1;
+    int last_mouse_y_ = -1;
 };
@@ -0,0 +1,185 @@
+#include "app_manifest.h"
+#include "log_msg.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    // Just enough JSON to walk a web app manifest, values are kept as text
+    class ManifestParser
+    {
+    public:
+        ManifestParser(const std::string &text, std::unordered_map<std::string, std::string> &out)
+            : text_(text), out_(out) {}
+
+        bool Parse()
+        {
+            SkipSpace();
+            if (!Consume('{'))
+                return false;
+            return ParseMembers("", false);
+        }
+
+    private:
+        void SkipSpace()
+        {
+            while (pos_ < text_.size() && isspace(static_cast<unsigned char>(text_[pos_])))
+                pos_++;
+        }
+
+        bool Consume(char c)
+        {
+            SkipSpace();
+            if (pos_ < text_.size() && text_[pos_] == c)
+            {
+                pos_++;
+                return true;
+            }
+            return false;
+        }
+
+        bool ParseString(std::string &s)
+        {
+            if (!Consume('"'))
+                return false;
+            while (pos_ < text_.size() && text_[pos_] != '"')
+            {
+                char c = text_[pos_++];
+                if (c == '\\' && pos_ < text_.size())
+                {
+                    c = text_[pos_++];
+                    switch (c)
+                    {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'u': pos_ += 4; c = '?'; break;  // not needed for options
+                    default: break;
+                    }
+                }
+                s += c;
+            }
+            return Consume('"');
+        }
+
+        // Members of an object, recorded under prefix when store is set
+        bool ParseMembers(const std::string &prefix, bool store)
+        {
+            if (Consume('}'))
+                return true;
+            do
+            {
+                std::string key;
+                if (!ParseString(key) || !Consume(':'))
+                    return false;
+                std::string path = prefix.empty() ? key : prefix + "." + key;
+                // Only the top-level "skyscript" object is of interest
+                bool store_value = store || (prefix.empty() && key == "skyscript");
+                if (!ParseValue(store ? path : "", store_value))
+                    return false;
+            } while (Consume(','));
+            return Consume('}');
+        }
+
+        bool ParseValue(const std::string &path, bool store)
+        {
+            SkipSpace();
+            if (pos_ >= text_.size())
+                return false;
+
+            char c = text_[pos_];
+            if (c == '{')
+            {
+                pos_++;
+                return ParseMembers(path, store);
+            }
+            if (c == '[')
+            {
+                pos_++;
+                if (Consume(']'))
+                    return true;
+                do
+                {
+                    if (!ParseValue("", false))
+                        return false;
+                } while (Consume(','));
+                return Consume(']');
+            }
+
+            std::string value;
+            if (c == '"')
+            {
+                if (!ParseString(value))
+                    return false;
+            }
+            else
+            {
+                // true, false, null or a number
+                while (pos_ < text_.size() && !strchr(",}] \t\r\n", text_[pos_]))
+                    value += text_[pos_++];
+                if (value.empty())
+                    return false;
+            }
+
+            if (store && !path.empty())
+                out_[path] = value;
+            return true;
+        }
+
+        const std::string &text_;
+        std::unordered_map<std::string, std::string> &out_;
+        size_t pos_ = 0;
+    };
+}
+
+bool AppManifest::Load(const std::string &app_dir)
+{
+    values_.clear();
+
+    std::ifstream file(app_dir + "/manifest.json");
+    if (!file)
+        return false;
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    if (!ManifestParser(text, values_).Parse())
+    {
+        LogMsg("Malformed manifest.json in %s, using defaults", app_dir.c_str());
+        values_.clear();
+        return false;
+    }
+    return true;
+}
+
+bool AppManifest::GetBool(const std::string &key, bool def) const
+{
+    auto it = values_.find(key);
+    if (it == values_.end())
+        return def;
+    if (it->second == "true" || it->second == "1")
+        return true;
+    if (it->second == "false" || it->second == "0")
+        return false;
+    return def;
+}
+
+double AppManifest::GetNumber(const std::string &key, double def) const
+{
+    auto it = values_.find(key);
+    if (it == values_.end())
+        return def;
+    char *end = nullptr;
+    double v = strtod(it->second.c_str(), &end);
+    return (end && *end == '\0' && end != it->second.c_str()) ? v : def;
+}
+
+std::string AppManifest::GetString(const std::string &key, const std::string &def) const
+{
+    auto it = values_.find(key);
+    return it == values_.end() ? def : it->second;
+}
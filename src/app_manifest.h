@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief SkyScript options read from an app's manifest.json
+ *
+ * Apps ship the regular web app manifest (public/manifest.json in the React
+ * samples). SkyScript only looks at its top-level "skyscript" object, e.g.
+ *
+ *   "skyscript": { "accelerated": true }
+ *
+ * Nested objects are flattened into dotted keys ("fps.focused"). Arrays are
+ * skipped. A missing file or a parse error leaves every option at its default.
+ */
+class AppManifest
+{
+public:
+    // Parse <app_dir>/manifest.json, returns false if it is missing or malformed
+    bool Load(const std::string &app_dir);
+
+    bool Has(const std::string &key) const { return values_.count(key) != 0; }
+    bool GetBool(const std::string &key, bool def) const;
+    double GetNumber(const std::string &key, double def) const;
+    std::string GetString(const std::string &key, const std::string &def) const;
+
+private:
+    std::unordered_map<std::string, std::string> values_;
+};
@@ -0,0 +1,53 @@
+#include "dataref_table.h"
+
+int DataRefTable::Find(const std::string &name, bool pending, double now)
+{
+    auto it = ids_.find(name);
+    if (it != ids_.end())
+        return pending || Resolve(it->second, now) ? it->second : 0;
+
+    XPLMDataRef ref = XPLMFindDataRef(name.c_str());
+    if (!ref && !pending)
+        return 0;
+
+    entries_.push_back({name, ref, ref ? 0.0 : now + kRetryInterval});
+    int handle = static_cast<int>(entries_.size());
+    ids_[name] = handle;
+    return handle;
+}
+
+XPLMDataRef DataRefTable::Resolve(int handle, double now)
+{
+    if (!Valid(handle))
+        return nullptr;
+
+    // Cleared by Release(), looked up again on first use. Plugins may register
+    // their datarefs after the page asked for them, so missing ones are retried.
+    Entry &entry = entries_[handle - 1];
+    if (!entry.ref)
+    {
+        if (now < entry.retry_at)
+            return nullptr;
+        entry.ref = XPLMFindDataRef(entry.name.c_str());
+        entry.retry_at = entry.ref ? 0.0 : now + kRetryInterval;
+    }
+    return entry.ref;
+}
+
+std::string DataRefTable::Name(int handle) const
+{
+    if (Valid(handle))
+        return entries_[handle - 1].name;
+    std::string name = "#";
+    name += std::to_string(handle);
+    return name;
+}
+
+void DataRefTable::Release()
+{
+    for (Entry &entry : entries_)
+    {
+        entry.ref = nullptr;
+        entry.retry_at = 0.0;
+    }
+}
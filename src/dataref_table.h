@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "XPLMDataAccess.h"
+
+/**
+ * @brief Dataref handles returned by XPlane.dataref.find(), shared by all apps
+ *
+ * A handle is index + 1 into a flat table, so a getter called with a handle
+ * costs one bounds check instead of a string conversion and a hash lookup.
+ * Handles keep their number for the life of the plugin: Release() only forgets
+ * the resolved refs (aircraft plugins publish their own datarefs), the next
+ * Resolve() looks the name up again. A dataref that doesn't exist yet is
+ * looked up at most once per kRetryInterval until some plugin registers it.
+ * Only used on the main thread.
+ */
+class DataRefTable
+{
+public:
+    static constexpr double kRetryInterval = 1.0;  // seconds between lookups of a missing dataref
+
+    /**
+     * @brief Handle for a dataref name
+     * @param name Dataref path
+     * @param pending Make a handle even if the dataref doesn't exist yet
+     * @param now Seconds on any monotonic clock, paces the retries
+     * @return Handle, 0 if the dataref doesn't exist and pending is false
+     */
+    int Find(const std::string &name, bool pending, double now);
+
+    // The handle's dataref, nullptr for an invalid handle or one that doesn't resolve (yet)
+    XPLMDataRef Resolve(int handle, double now);
+
+    bool Valid(int handle) const { return handle >= 1 && handle <= static_cast<int>(entries_.size()); }
+
+    // Dataref path of a handle, "#<handle>" for an invalid one
+    std::string Name(int handle) const;
+
+    // Forget every resolved ref, handles stay valid and resolve again on use
+    void Release();
+
+    size_t size() const { return entries_.size(); }
+
+private:
+    struct Entry
+    {
+        std::string name;
+        XPLMDataRef ref = nullptr;  // nullptr after Release(), looked up again on use
+        double retry_at = 0.0;      // next lookup of a dataref that wasn't there yet
+    };
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, int> ids_;
+};
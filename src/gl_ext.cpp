@@ -0,0 +1,229 @@
+#include "gl_ext.h"
+#include "log_msg.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if !IBM
+#include <dlfcn.h>
+#endif
+
+// Static member definitions
+bool GLExt::loaded_ = false;
+bool GLExt::shader_pipeline_ = false;
+int GLExt::major_ = 1;
+int GLExt::minor_ = 1;
+
+GLExt::PFN_TexStorage2D GLExt::TexStorage2D = nullptr;
+GLExt::PFN_GetStringi GLExt::GetStringi = nullptr;
+
+GLExt::PFN_GenBuffers GLExt::GenBuffers = nullptr;
+GLExt::PFN_DeleteBuffers GLExt::DeleteBuffers = nullptr;
+GLExt::PFN_BindBuffer GLExt::BindBuffer = nullptr;
+GLExt::PFN_BufferData GLExt::BufferData = nullptr;
+GLExt::PFN_MapBufferRange GLExt::MapBufferRange = nullptr;
+GLExt::PFN_UnmapBuffer GLExt::UnmapBuffer = nullptr;
+
+GLExt::PFN_FenceSync GLExt::FenceSync = nullptr;
+GLExt::PFN_ClientWaitSync GLExt::ClientWaitSync = nullptr;
+GLExt::PFN_DeleteSync GLExt::DeleteSync = nullptr;
+
+GLExt::PFN_BufferStorage GLExt::BufferStorage = nullptr;
+
+GLExt::PFN_CreateShader GLExt::CreateShader = nullptr;
+GLExt::PFN_ShaderSource GLExt::ShaderSource = nullptr;
+GLExt::PFN_CompileShader GLExt::CompileShader = nullptr;
+GLExt::PFN_GetShaderiv GLExt::GetShaderiv = nullptr;
+GLExt::PFN_GetShaderInfoLog GLExt::GetShaderInfoLog = nullptr;
+GLExt::PFN_DeleteShader GLExt::DeleteShader = nullptr;
+GLExt::PFN_CreateProgram GLExt::CreateProgram = nullptr;
+GLExt::PFN_AttachShader GLExt::AttachShader = nullptr;
+GLExt::PFN_BindAttribLocation GLExt::BindAttribLocation = nullptr;
+GLExt::PFN_LinkProgram GLExt::LinkProgram = nullptr;
+GLExt::PFN_GetProgramiv GLExt::GetProgramiv = nullptr;
+GLExt::PFN_GetProgramInfoLog GLExt::GetProgramInfoLog = nullptr;
+GLExt::PFN_DeleteProgram GLExt::DeleteProgram = nullptr;
+GLExt::PFN_UseProgram GLExt::UseProgram = nullptr;
+GLExt::PFN_GetUniformLocation GLExt::GetUniformLocation = nullptr;
+GLExt::PFN_Uniform1i GLExt::Uniform1i = nullptr;
+GLExt::PFN_Uniform1ui GLExt::Uniform1ui = nullptr;
+GLExt::PFN_Uniform4fv GLExt::Uniform4fv = nullptr;
+GLExt::PFN_UniformMatrix4fv GLExt::UniformMatrix4fv = nullptr;
+GLExt::PFN_GenVertexArrays GLExt::GenVertexArrays = nullptr;
+GLExt::PFN_BindVertexArray GLExt::BindVertexArray = nullptr;
+GLExt::PFN_DeleteVertexArrays GLExt::DeleteVertexArrays = nullptr;
+GLExt::PFN_EnableVertexAttribArray GLExt::EnableVertexAttribArray = nullptr;
+GLExt::PFN_VertexAttribPointer GLExt::VertexAttribPointer = nullptr;
+GLExt::PFN_BufferSubData GLExt::BufferSubData = nullptr;
+GLExt::PFN_GenFramebuffers GLExt::GenFramebuffers = nullptr;
+GLExt::PFN_DeleteFramebuffers GLExt::DeleteFramebuffers = nullptr;
+GLExt::PFN_BindFramebuffer GLExt::BindFramebuffer = nullptr;
+GLExt::PFN_FramebufferTexture2D GLExt::FramebufferTexture2D = nullptr;
+GLExt::PFN_CheckFramebufferStatus GLExt::CheckFramebufferStatus = nullptr;
+GLExt::PFN_ActiveTexture GLExt::ActiveTexture = nullptr;
+
+void *GLExt::GetProc(const char *name)
+{
+#if IBM
+    void *proc = reinterpret_cast<void *>(wglGetProcAddress(name));
+    // wglGetProcAddress may return small sentinel values instead of nullptr
+    intptr_t v = reinterpret_cast<intptr_t>(proc);
+    if (v == 0 || v == 1 || v == 2 || v == 3 || v == -1)
+    {
+        static HMODULE opengl32 = LoadLibraryA("opengl32.dll");
+        proc = opengl32 ? reinterpret_cast<void *>(GetProcAddress(opengl32, name)) : nullptr;
+    }
+    return proc;
+#elif APL
+    return dlsym(RTLD_DEFAULT, name);
+#else
+    // glXGetProcAddress returns non-null for any name, so callers must check
+    // the version/extension before trusting a pointer.
+    typedef void *(*GetProcAddressFn)(const char *);
+    static GetProcAddressFn glx_get_proc =
+        reinterpret_cast<GetProcAddressFn>(dlsym(RTLD_DEFAULT, "glXGetProcAddressARB"));
+    static GetProcAddressFn egl_get_proc =
+        reinterpret_cast<GetProcAddressFn>(dlsym(RTLD_DEFAULT, "eglGetProcAddress"));
+
+    void *proc = dlsym(RTLD_DEFAULT, name);
+    if (!proc && glx_get_proc)
+        proc = glx_get_proc(name);
+    if (!proc && egl_get_proc)
+        proc = egl_get_proc(name);
+    return proc;
+#endif
+}
+
+bool GLExt::HasVersion(int major, int minor)
+{
+    return major_ > major || (major_ == major && minor_ >= minor);
+}
+
+bool GLExt::HasExtension(const char *name)
+{
+    if (GetStringi)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            const char *ext = reinterpret_cast<const char *>(GetStringi(GL_EXTENSIONS, i));
+            if (ext && strcmp(ext, name) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    const char *exts = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+    if (!exts)
+        return false;
+
+    // Match whole words only, "GL_ARB_foo" must not match "GL_ARB_foo_bar"
+    size_t len = strlen(name);
+    for (const char *p = strstr(exts, name); p; p = strstr(p + len, name))
+    {
+        if ((p == exts || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+void GLExt::Load()
+{
+    if (loaded_)
+        return;
+
+    const char *version = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+    if (!version)
+    {
+        // No current context yet, try again next time
+        return;
+    }
+    loaded_ = true;
+
+    if (sscanf(version, "%d.%d", &major_, &minor_) != 2)
+    {
+        major_ = 1;
+        minor_ = 1;
+    }
+
+    if (HasVersion(3, 0))
+        GetStringi = reinterpret_cast<PFN_GetStringi>(GetProc("glGetStringi"));
+
+    if (HasVersion(4, 2) || HasExtension("GL_ARB_texture_storage"))
+        TexStorage2D = reinterpret_cast<PFN_TexStorage2D>(GetProc("glTexStorage2D"));
+
+    if (HasVersion(3, 0) ||
+        (HasExtension("GL_ARB_pixel_buffer_object") && HasExtension("GL_ARB_map_buffer_range")))
+    {
+        GenBuffers = reinterpret_cast<PFN_GenBuffers>(GetProc("glGenBuffers"));
+        DeleteBuffers = reinterpret_cast<PFN_DeleteBuffers>(GetProc("glDeleteBuffers"));
+        BindBuffer = reinterpret_cast<PFN_BindBuffer>(GetProc("glBindBuffer"));
+        BufferData = reinterpret_cast<PFN_BufferData>(GetProc("glBufferData"));
+        UnmapBuffer = reinterpret_cast<PFN_UnmapBuffer>(GetProc("glUnmapBuffer"));
+        if (GenBuffers && DeleteBuffers && BindBuffer && BufferData && UnmapBuffer)
+            MapBufferRange = reinterpret_cast<PFN_MapBufferRange>(GetProc("glMapBufferRange"));
+    }
+
+    if (HasVersion(3, 2) || HasExtension("GL_ARB_sync"))
+    {
+        ClientWaitSync = reinterpret_cast<PFN_ClientWaitSync>(GetProc("glClientWaitSync"));
+        DeleteSync = reinterpret_cast<PFN_DeleteSync>(GetProc("glDeleteSync"));
+        if (ClientWaitSync && DeleteSync)
+            FenceSync = reinterpret_cast<PFN_FenceSync>(GetProc("glFenceSync"));
+    }
+
+    if (HasVersion(4, 4) || HasExtension("GL_ARB_buffer_storage"))
+        BufferStorage = reinterpret_cast<PFN_BufferStorage>(GetProc("glBufferStorage"));
+
+    if (HasVersion(3, 2))
+    {
+#define GLEXT_RESOLVE(name) name = reinterpret_cast<PFN_##name>(GetProc("gl" #name))
+        GLEXT_RESOLVE(CreateShader);
+        GLEXT_RESOLVE(ShaderSource);
+        GLEXT_RESOLVE(CompileShader);
+        GLEXT_RESOLVE(GetShaderiv);
+        GLEXT_RESOLVE(GetShaderInfoLog);
+        GLEXT_RESOLVE(DeleteShader);
+        GLEXT_RESOLVE(CreateProgram);
+        GLEXT_RESOLVE(AttachShader);
+        GLEXT_RESOLVE(BindAttribLocation);
+        GLEXT_RESOLVE(LinkProgram);
+        GLEXT_RESOLVE(GetProgramiv);
+        GLEXT_RESOLVE(GetProgramInfoLog);
+        GLEXT_RESOLVE(DeleteProgram);
+        GLEXT_RESOLVE(UseProgram);
+        GLEXT_RESOLVE(GetUniformLocation);
+        GLEXT_RESOLVE(Uniform1i);
+        GLEXT_RESOLVE(Uniform1ui);
+        GLEXT_RESOLVE(Uniform4fv);
+        GLEXT_RESOLVE(UniformMatrix4fv);
+        GLEXT_RESOLVE(GenVertexArrays);
+        GLEXT_RESOLVE(BindVertexArray);
+        GLEXT_RESOLVE(DeleteVertexArrays);
+        GLEXT_RESOLVE(EnableVertexAttribArray);
+        GLEXT_RESOLVE(VertexAttribPointer);
+        GLEXT_RESOLVE(BufferSubData);
+        GLEXT_RESOLVE(GenFramebuffers);
+        GLEXT_RESOLVE(DeleteFramebuffers);
+        GLEXT_RESOLVE(BindFramebuffer);
+        GLEXT_RESOLVE(FramebufferTexture2D);
+        GLEXT_RESOLVE(CheckFramebufferStatus);
+        GLEXT_RESOLVE(ActiveTexture);
+#undef GLEXT_RESOLVE
+
+        shader_pipeline_ = CreateShader && ShaderSource && CompileShader && GetShaderiv && GetShaderInfoLog &&
+                           DeleteShader && CreateProgram && AttachShader && BindAttribLocation && LinkProgram &&
+                           GetProgramiv && GetProgramInfoLog && DeleteProgram && UseProgram &&
+                           GetUniformLocation && Uniform1i && Uniform1ui && Uniform4fv && UniformMatrix4fv &&
+                           GenVertexArrays && BindVertexArray && DeleteVertexArrays &&
+                           EnableVertexAttribArray && VertexAttribPointer && BufferSubData &&
+                           GenFramebuffers && DeleteFramebuffers && BindFramebuffer && FramebufferTexture2D &&
+                           CheckFramebufferStatus && ActiveTexture && GenBuffers && BindBuffer && BufferData;
+    }
+
+    LogMsg("GLExt: OpenGL %d.%d (%s), texture storage: %d, pixel buffers: %d, sync: %d, buffer storage: %d, "
+           "shader pipeline: %d",
+           major_, minor_, version, HasTexStorage(), HasPixelBuffers(), HasSync(), HasBufferStorage(),
+           HasShaderPipeline());
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if IBM
+#include <windows.h>
+#endif
+
+#if APL
+#include <OpenGL/gl.h>
+#elif LIN || IBM
+#include <GL/gl.h>
+#endif
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// Windows gl.h doesn't include these OpenGL 1.2+ constants
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+#ifndef GL_BGRA
+#define GL_BGRA 0x80E1
+#endif
+#ifndef GL_RGBA8
+#define GL_RGBA8 0x8058
+#endif
+#ifndef GL_NUM_EXTENSIONS
+#define GL_NUM_EXTENSIONS 0x821D
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#define GL_PIXEL_UNPACK_BUFFER_BINDING 0x88EF
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_READ_BIT 0x0001
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#define GL_INFO_LOG_LENGTH 0x8B84
+#define GL_CURRENT_PROGRAM 0x8B8D
+#endif
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_ARRAY_BUFFER_BINDING 0x8894
+#define GL_DYNAMIC_DRAW 0x88E8
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0 0x84C0
+#define GL_ACTIVE_TEXTURE 0x84E0
+#endif
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_FRAMEBUFFER_BINDING 0x8CA6
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#endif
+#ifndef GL_VERTEX_ARRAY_BINDING
+#define GL_VERTEX_ARRAY_BINDING 0x85B5
+#endif
+#ifndef GL_R8
+#define GL_R8 0x8229
+#define GL_RED 0x1903
+#endif
+
+// GL 1.5 / 3.2 types missing from old headers
+typedef ptrdiff_t GLExtSizeiptr;
+typedef ptrdiff_t GLExtIntptr;
+typedef struct __GLsync *GLExtSync;
+
+/**
+ * @brief Runtime-resolved OpenGL entry points
+ *
+ * X-Plane hands plugins a compatibility context, but the system gl.h only
+ * declares OpenGL 1.1 on Windows. Everything newer is resolved here once a
+ * context is current, and callers check the Has*() helpers before use.
+ */
+class GLExt {
+public:
+    /**
+     * @brief Resolve all optional entry points
+     *
+     * Requires a current GL context. Safe to call repeatedly, only the first
+     * call does any work.
+     */
+    static void Load();
+
+    static bool IsLoaded() { return loaded_; }
+    static bool HasVersion(int major, int minor);
+    static bool HasExtension(const char *name);
+
+    // glTexStorage2D (GL 4.2 / ARB_texture_storage)
+    static bool HasTexStorage() { return TexStorage2D != nullptr; }
+
+    // Pixel unpack buffers with glMapBufferRange (GL 3.0 / ARB_pixel_buffer_object + ARB_map_buffer_range)
+    static bool HasPixelBuffers() { return MapBufferRange != nullptr; }
+
+    // Fence objects (GL 3.2 / ARB_sync)
+    static bool HasSync() { return FenceSync != nullptr; }
+
+    // Persistently mapped buffers (GL 4.4 / ARB_buffer_storage), only useful with fences
+    static bool HasBufferStorage() { return BufferStorage != nullptr && HasPixelBuffers() && HasSync(); }
+
+    // GLSL 1.50 programs, vertex arrays and framebuffer objects (GL 3.2), used by GPUDriverGL
+    static bool HasShaderPipeline() { return shader_pipeline_; }
+
+    typedef void (APIENTRY *PFN_TexStorage2D)(GLenum target, GLsizei levels, GLenum internalformat,
+                                              GLsizei width, GLsizei height);
+    typedef const GLubyte *(APIENTRY *PFN_GetStringi)(GLenum name, GLuint index);
+    typedef void (APIENTRY *PFN_GenBuffers)(GLsizei n, GLuint *buffers);
+    typedef void (APIENTRY *PFN_DeleteBuffers)(GLsizei n, const GLuint *buffers);
+    typedef void (APIENTRY *PFN_BindBuffer)(GLenum target, GLuint buffer);
+    typedef void (APIENTRY *PFN_BufferData)(GLenum target, GLExtSizeiptr size, const void *data, GLenum usage);
+    typedef void *(APIENTRY *PFN_MapBufferRange)(GLenum target, GLExtIntptr offset, GLExtSizeiptr length,
+                                                 GLbitfield access);
+    typedef GLboolean (APIENTRY *PFN_UnmapBuffer)(GLenum target);
+    typedef GLExtSync (APIENTRY *PFN_FenceSync)(GLenum condition, GLbitfield flags);
+    typedef GLenum (APIENTRY *PFN_ClientWaitSync)(GLExtSync sync, GLbitfield flags, uint64_t timeout);
+    typedef void (APIENTRY *PFN_DeleteSync)(GLExtSync sync);
+    typedef void (APIENTRY *PFN_BufferStorage)(GLenum target, GLExtSizeiptr size, const void *data,
+                                               GLbitfield flags);
+
+    static PFN_TexStorage2D TexStorage2D;
+    static PFN_GetStringi GetStringi;
+
+    static PFN_GenBuffers GenBuffers;
+    static PFN_DeleteBuffers DeleteBuffers;
+    static PFN_BindBuffer BindBuffer;
+    static PFN_BufferData BufferData;
+    static PFN_MapBufferRange MapBufferRange;
+    static PFN_UnmapBuffer UnmapBuffer;
+
+    static PFN_FenceSync FenceSync;
+    static PFN_ClientWaitSync ClientWaitSync;
+    static PFN_DeleteSync DeleteSync;
+
+    static PFN_BufferStorage BufferStorage;
+
+    typedef char GLExtChar;
+    typedef GLuint (APIENTRY *PFN_CreateShader)(GLenum type);
+    typedef void (APIENTRY *PFN_ShaderSource)(GLuint shader, GLsizei count, const GLExtChar *const *string,
+                                              const GLint *length);
+    typedef void (APIENTRY *PFN_CompileShader)(GLuint shader);
+    typedef void (APIENTRY *PFN_GetShaderiv)(GLuint shader, GLenum pname, GLint *params);
+    typedef void (APIENTRY *PFN_GetShaderInfoLog)(GLuint shader, GLsizei max_length, GLsizei *length,
+                                                  GLExtChar *info_log);
+    typedef void (APIENTRY *PFN_DeleteShader)(GLuint shader);
+    typedef GLuint (APIENTRY *PFN_CreateProgram)();
+    typedef void (APIENTRY *PFN_AttachShader)(GLuint program, GLuint shader);
+    typedef void (APIENTRY *PFN_BindAttribLocation)(GLuint program, GLuint index, const GLExtChar *name);
+    typedef void (APIENTRY *PFN_LinkProgram)(GLuint program);
+    typedef void (APIENTRY *PFN_GetProgramiv)(GLuint program, GLenum pname, GLint *params);
+    typedef void (APIENTRY *PFN_GetProgramInfoLog)(GLuint program, GLsizei max_length, GLsizei *length,
+                                                   GLExtChar *info_log);
+    typedef void (APIENTRY *PFN_DeleteProgram)(GLuint program);
+    typedef void (APIENTRY *PFN_UseProgram)(GLuint program);
+    typedef GLint (APIENTRY *PFN_GetUniformLocation)(GLuint program, const GLExtChar *name);
+    typedef void (APIENTRY *PFN_Uniform1i)(GLint location, GLint v0);
+    typedef void (APIENTRY *PFN_Uniform1ui)(GLint location, GLuint v0);
+    typedef void (APIENTRY *PFN_Uniform4fv)(GLint location, GLsizei count, const GLfloat *value);
+    typedef void (APIENTRY *PFN_UniformMatrix4fv)(GLint location, GLsizei count, GLboolean transpose,
+                                                  const GLfloat *value);
+    typedef void (APIENTRY *PFN_GenVertexArrays)(GLsizei n, GLuint *arrays);
+    typedef void (APIENTRY *PFN_BindVertexArray)(GLuint array);
+    typedef void (APIENTRY *PFN_DeleteVertexArrays)(GLsizei n, const GLuint *arrays);
+    typedef void (APIENTRY *PFN_EnableVertexAttribArray)(GLuint index);
+    typedef void (APIENTRY *PFN_VertexAttribPointer)(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                                                     GLsizei stride, const void *pointer);
+    typedef void (APIENTRY *PFN_BufferSubData)(GLenum target, GLExtIntptr offset, GLExtSizeiptr size,
+                                               const void *data);
+    typedef void (APIENTRY *PFN_GenFramebuffers)(GLsizei n, GLuint *framebuffers);
+    typedef void (APIENTRY *PFN_DeleteFramebuffers)(GLsizei n, const GLuint *framebuffers);
+    typedef void (APIENTRY *PFN_BindFramebuffer)(GLenum target, GLuint framebuffer);
+    typedef void (APIENTRY *PFN_FramebufferTexture2D)(GLenum target, GLenum attachment, GLenum textarget,
+                                                      GLuint texture, GLint level);
+    typedef GLenum (APIENTRY *PFN_CheckFramebufferStatus)(GLenum target);
+    typedef void (APIENTRY *PFN_ActiveTexture)(GLenum texture);
+
+    static PFN_CreateShader CreateShader;
+    static PFN_ShaderSource ShaderSource;
+    static PFN_CompileShader CompileShader;
+    static PFN_GetShaderiv GetShaderiv;
+    static PFN_GetShaderInfoLog GetShaderInfoLog;
+    static PFN_DeleteShader DeleteShader;
+    static PFN_CreateProgram CreateProgram;
+    static PFN_AttachShader AttachShader;
+    static PFN_BindAttribLocation BindAttribLocation;
+    static PFN_LinkProgram LinkProgram;
+    static PFN_GetProgramiv GetProgramiv;
+    static PFN_GetProgramInfoLog GetProgramInfoLog;
+    static PFN_DeleteProgram DeleteProgram;
+    static PFN_UseProgram UseProgram;
+    static PFN_GetUniformLocation GetUniformLocation;
+    static PFN_Uniform1i Uniform1i;
+    static PFN_Uniform1ui Uniform1ui;
+    static PFN_Uniform4fv Uniform4fv;
+    static PFN_UniformMatrix4fv UniformMatrix4fv;
+    static PFN_GenVertexArrays GenVertexArrays;
+    static PFN_BindVertexArray BindVertexArray;
+    static PFN_DeleteVertexArrays DeleteVertexArrays;
+    static PFN_EnableVertexAttribArray EnableVertexAttribArray;
+    static PFN_VertexAttribPointer VertexAttribPointer;
+    static PFN_BufferSubData BufferSubData;
+    static PFN_GenFramebuffers GenFramebuffers;
+    static PFN_DeleteFramebuffers DeleteFramebuffers;
+    static PFN_BindFramebuffer BindFramebuffer;
+    static PFN_FramebufferTexture2D FramebufferTexture2D;
+    static PFN_CheckFramebufferStatus CheckFramebufferStatus;
+    static PFN_ActiveTexture ActiveTexture;
+
+private:
+    static void *GetProc(const char *name);
+
+    static bool loaded_;
+    static bool shader_pipeline_;
+    static int major_;
+    static int minor_;
+};
@@ -0,0 +1,599 @@
+#include "gpu_driver_gl.h"
+#include "log_msg.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// GLSL 1.50 sources bundled with the Ultralight SDK (shaders/glsl)
+#include "shader_fill_frag.h"
+#include "shader_fill_path_frag.h"
+#include "shader_v2f_c4f_t2f_t2f_d28f_vert.h"
+#include "shader_v2f_c4f_t2f_vert.h"
+
+#ifndef GL_FRAMEBUFFER_SRGB
+#define GL_FRAMEBUFFER_SRGB 0x8DB9
+#endif
+
+namespace
+{
+    // Attribute locations, bound before linking so the VAOs don't depend on the compiler
+    const char *const kFillAttribs[] = {"in_Position", "in_Color", "in_TexCoord", "in_ObjCoord",
+                                        "in_Data0", "in_Data1", "in_Data2", "in_Data3",
+                                        "in_Data4", "in_Data5", "in_Data6"};
+    const char *const kPathAttribs[] = {"in_Position", "in_Color", "in_TexCoord"};
+
+    const auto kStartTime = std::chrono::steady_clock::now();
+
+    GLuint CompileShader(GLenum type, const char *source)
+    {
+        GLuint shader = GLExt::CreateShader(type);
+        GLExt::ShaderSource(shader, 1, &source, nullptr);
+        GLExt::CompileShader(shader);
+
+        GLint ok = 0;
+        GLExt::GetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        if (!ok)
+        {
+            char log[1024] = {};
+            GLExt::GetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            LogMsg("GPUDriverGL: shader compile failed: %s", log);
+            GLExt::DeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    // Orthographic projection * transform, column-major like Matrix4x4. Projecting with
+    // flip_y puts view row 0 at texture row 0, so render buffers read top-down like bitmaps.
+    void Projection(const Matrix4x4 &transform, float width, float height, bool flip_y, float out[16])
+    {
+        float proj[16] = {};
+        proj[0] = 2.0f / width;
+        proj[5] = flip_y ? 2.0f / height : -2.0f / height;
+        proj[10] = 1.0f;
+        proj[12] = -1.0f;
+        proj[13] = flip_y ? -1.0f : 1.0f;
+        proj[15] = 1.0f;
+
+        for (int col = 0; col < 4; col++)
+        {
+            for (int row = 0; row < 4; row++)
+            {
+                float sum = 0.0f;
+                for (int k = 0; k < 4; k++)
+                    sum += proj[k * 4 + row] * transform.data[col * 4 + k];
+                out[col * 4 + row] = sum;
+            }
+        }
+    }
+
+    void VertexAttrib(GLuint index, GLint size, GLenum type, bool normalized, GLsizei stride, size_t offset)
+    {
+        GLExt::EnableVertexAttribArray(index);
+        GLExt::VertexAttribPointer(index, size, type, normalized ? GL_TRUE : GL_FALSE, stride,
+                                   reinterpret_cast<const void *>(offset));
+    }
+}
+
+GPUDriverGL &GPUDriverGL::instance()
+{
+    static GPUDriverGL instance;
+    return instance;
+}
+
+bool GPUDriverGL::Install()
+{
+    if (installed_)
+        return true;
+
+    GLExt::Load();
+    if (!GLExt::HasShaderPipeline())
+    {
+        LogMsg("GPUDriverGL: OpenGL 3.2 not available, accelerated views disabled");
+        return false;
+    }
+
+    Platform::instance().set_gpu_driver(this);
+    installed_ = true;
+    LogMsg("GPUDriverGL: installed");
+    return true;
+}
+
+void GPUDriverGL::Shutdown()
+{
+    for (auto &[id, entry] : geometry_)
+    {
+        GLExt::DeleteVertexArrays(1, &entry.vao);
+        GLExt::DeleteBuffers(1, &entry.vbo);
+        GLExt::DeleteBuffers(1, &entry.ebo);
+    }
+    for (auto &[id, entry] : render_buffers_)
+    {
+        if (entry.fbo)
+            GLExt::DeleteFramebuffers(1, &entry.fbo);
+    }
+    for (auto &[id, entry] : textures_)
+    {
+        glDeleteTextures(1, &entry.tex);
+    }
+    geometry_.clear();
+    render_buffers_.clear();
+    textures_.clear();
+    command_list_.clear();
+
+    if (fill_program_.id)
+        GLExt::DeleteProgram(fill_program_.id);
+    if (path_program_.id)
+        GLExt::DeleteProgram(path_program_.id);
+    fill_program_ = Program();
+    path_program_ = Program();
+    programs_loaded_ = false;
+    programs_failed_ = false;
+}
+
+GLuint GPUDriverGL::GetGLTexture(uint32_t texture_id) const
+{
+    auto it = textures_.find(texture_id);
+    return it == textures_.end() ? 0 : it->second.tex;
+}
+
+void GPUDriverGL::SaveState(SavedState &state)
+{
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &state.active_texture);
+    for (int i = 0; i < 3; i++)
+    {
+        GLExt::ActiveTexture(GL_TEXTURE0 + i);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &state.textures[i]);
+    }
+    GLExt::ActiveTexture(GL_TEXTURE0);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &state.array_buffer);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &state.vertex_array);
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &state.unpack_buffer);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &state.framebuffer);
+    glGetIntegerv(GL_CURRENT_PROGRAM, &state.program);
+
+    // Bitmaps are client memory, and uploads must not land in someone else's VAO
+    GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+}
+
+void GPUDriverGL::RestoreState(const SavedState &state)
+{
+    glPopClientAttrib();
+    GLExt::UseProgram(state.program);
+    GLExt::BindFramebuffer(GL_FRAMEBUFFER, state.framebuffer);
+    GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, state.unpack_buffer);
+    GLExt::BindVertexArray(state.vertex_array);
+    GLExt::BindBuffer(GL_ARRAY_BUFFER, state.array_buffer);
+    for (int i = 2; i >= 0; i--)
+    {
+        GLExt::ActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, state.textures[i]);
+    }
+    GLExt::ActiveTexture(state.active_texture);
+}
+
+void GPUDriverGL::BeginSynchronize()
+{
+    SaveState(sync_state_);
+    synchronizing_ = true;
+}
+
+void GPUDriverGL::EndSynchronize()
+{
+    synchronizing_ = false;
+    RestoreState(sync_state_);
+}
+
+void GPUDriverGL::UploadBitmap(RefPtr<Bitmap> bitmap)
+{
+    GLenum internal_format = GL_RGBA8;
+    GLenum format = GL_BGRA;
+    if (bitmap->format() == BitmapFormat::A8_UNORM)
+    {
+        internal_format = GL_R8;
+        format = GL_RED;
+    }
+
+    // The shaders do their own blending in sRGB space, so BGRA8_UNORM_SRGB is stored as plain RGBA8
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, bitmap->row_bytes() / bitmap->bpp());
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+
+    const void *pixels = bitmap->LockPixels();
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, bitmap->width(), bitmap->height(), 0,
+                 format, GL_UNSIGNED_BYTE, pixels);
+    bitmap->UnlockPixels();
+}
+
+void GPUDriverGL::CreateTexture(uint32_t texture_id, RefPtr<Bitmap> bitmap)
+{
+    SavedState saved;
+    if (!synchronizing_)
+        SaveState(saved);
+
+    TextureEntry &entry = textures_[texture_id];
+    glGenTextures(1, &entry.tex);
+    entry.width = bitmap->width();
+    entry.height = bitmap->height();
+
+    GLExt::ActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, entry.tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    if (bitmap->IsEmpty())
+    {
+        // Render target storage, filled by a render buffer
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, entry.width, entry.height, 0,
+                     GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    else
+    {
+        UploadBitmap(bitmap);
+    }
+
+    if (!synchronizing_)
+        RestoreState(saved);
+}
+
+void GPUDriverGL::UpdateTexture(uint32_t texture_id, RefPtr<Bitmap> bitmap)
+{
+    auto it = textures_.find(texture_id);
+    if (it == textures_.end() || bitmap->IsEmpty())
+        return;
+
+    SavedState saved;
+    if (!synchronizing_)
+        SaveState(saved);
+
+    it->second.width = bitmap->width();
+    it->second.height = bitmap->height();
+    GLExt::ActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, it->second.tex);
+    UploadBitmap(bitmap);
+
+    if (!synchronizing_)
+        RestoreState(saved);
+}
+
+void GPUDriverGL::DestroyTexture(uint32_t texture_id)
+{
+    auto it = textures_.find(texture_id);
+    if (it == textures_.end())
+        return;
+    glDeleteTextures(1, &it->second.tex);
+    textures_.erase(it);
+}
+
+void GPUDriverGL::CreateRenderBuffer(uint32_t render_buffer_id, const RenderBuffer &buffer)
+{
+    // The FBO is created on first use, the backing texture may not exist yet
+    RenderBufferEntry &entry = render_buffers_[render_buffer_id];
+    entry.texture_id = buffer.texture_id;
+    entry.width = buffer.width;
+    entry.height = buffer.height;
+}
+
+void GPUDriverGL::DestroyRenderBuffer(uint32_t render_buffer_id)
+{
+    auto it = render_buffers_.find(render_buffer_id);
+    if (it == render_buffers_.end())
+        return;
+    if (it->second.fbo)
+        GLExt::DeleteFramebuffers(1, &it->second.fbo);
+    render_buffers_.erase(it);
+}
+
+void GPUDriverGL::UploadGeometry(GeometryEntry &geometry, const VertexBuffer &vertices, const IndexBuffer &indices)
+{
+    // The element buffer binding is VAO state, never touch it with another VAO bound
+    GLExt::BindVertexArray(geometry.vao);
+
+    GLExt::BindBuffer(GL_ARRAY_BUFFER, geometry.vbo);
+    GLExt::BufferData(GL_ARRAY_BUFFER, vertices.size, vertices.data, GL_DYNAMIC_DRAW);
+    GLExt::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry.ebo);
+    GLExt::BufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size, indices.data, GL_DYNAMIC_DRAW);
+}
+
+void GPUDriverGL::CreateGeometry(uint32_t geometry_id, const VertexBuffer &vertices, const IndexBuffer &indices)
+{
+    SavedState saved;
+    if (!synchronizing_)
+        SaveState(saved);
+
+    GeometryEntry &geometry = geometry_[geometry_id];
+    geometry.format = vertices.format;
+    GLExt::GenVertexArrays(1, &geometry.vao);
+    GLExt::GenBuffers(1, &geometry.vbo);
+    GLExt::GenBuffers(1, &geometry.ebo);
+    UploadGeometry(geometry, vertices, indices);
+
+    if (vertices.format == VertexBufferFormat::_2f_4ub_2f_2f_28f)
+    {
+        typedef Vertex_2f_4ub_2f_2f_28f V;
+        VertexAttrib(0, 2, GL_FLOAT, false, sizeof(V), offsetof(V, pos));
+        VertexAttrib(1, 4, GL_UNSIGNED_BYTE, true, sizeof(V), offsetof(V, color));
+        VertexAttrib(2, 2, GL_FLOAT, false, sizeof(V), offsetof(V, tex));
+        VertexAttrib(3, 2, GL_FLOAT, false, sizeof(V), offsetof(V, obj));
+        for (int i = 0; i < 7; i++)
+            VertexAttrib(4 + i, 4, GL_FLOAT, false, sizeof(V), offsetof(V, data0) + sizeof(V::data0) * i);
+    }
+    else
+    {
+        // Path vertices only carry object coordinates, bound as in_TexCoord
+        typedef Vertex_2f_4ub_2f V;
+        VertexAttrib(0, 2, GL_FLOAT, false, sizeof(V), offsetof(V, pos));
+        VertexAttrib(1, 4, GL_UNSIGNED_BYTE, true, sizeof(V), offsetof(V, color));
+        VertexAttrib(2, 2, GL_FLOAT, false, sizeof(V), offsetof(V, obj));
+    }
+
+    if (!synchronizing_)
+        RestoreState(saved);
+}
+
+void GPUDriverGL::UpdateGeometry(uint32_t geometry_id, const VertexBuffer &vertices, const IndexBuffer &indices)
+{
+    auto it = geometry_.find(geometry_id);
+    if (it == geometry_.end())
+        return;
+
+    SavedState saved;
+    if (!synchronizing_)
+        SaveState(saved);
+
+    UploadGeometry(it->second, vertices, indices);
+
+    if (!synchronizing_)
+        RestoreState(saved);
+}
+
+void GPUDriverGL::DestroyGeometry(uint32_t geometry_id)
+{
+    auto it = geometry_.find(geometry_id);
+    if (it == geometry_.end())
+        return;
+    GLExt::DeleteVertexArrays(1, &it->second.vao);
+    GLExt::DeleteBuffers(1, &it->second.vbo);
+    GLExt::DeleteBuffers(1, &it->second.ebo);
+    geometry_.erase(it);
+}
+
+void GPUDriverGL::UpdateCommandList(const CommandList &list)
+{
+    command_list_.insert(command_list_.end(), list.commands, list.commands + list.size);
+}
+
+bool GPUDriverGL::CompileProgram(Program &program, const char *vert, const char *frag, bool fill)
+{
+    GLuint vs = CompileShader(GL_VERTEX_SHADER, vert);
+    GLuint fs = CompileShader(GL_FRAGMENT_SHADER, frag);
+    if (!vs || !fs)
+    {
+        if (vs)
+            GLExt::DeleteShader(vs);
+        if (fs)
+            GLExt::DeleteShader(fs);
+        return false;
+    }
+
+    program.id = GLExt::CreateProgram();
+    GLExt::AttachShader(program.id, vs);
+    GLExt::AttachShader(program.id, fs);
+    if (fill)
+    {
+        for (GLuint i = 0; i < sizeof(kFillAttribs) / sizeof(kFillAttribs[0]); i++)
+            GLExt::BindAttribLocation(program.id, i, kFillAttribs[i]);
+    }
+    else
+    {
+        for (GLuint i = 0; i < sizeof(kPathAttribs) / sizeof(kPathAttribs[0]); i++)
+            GLExt::BindAttribLocation(program.id, i, kPathAttribs[i]);
+    }
+    GLExt::LinkProgram(program.id);
+    GLExt::DeleteShader(vs);
+    GLExt::DeleteShader(fs);
+
+    GLint ok = 0;
+    GLExt::GetProgramiv(program.id, GL_LINK_STATUS, &ok);
+    if (!ok)
+    {
+        char log[1024] = {};
+        GLExt::GetProgramInfoLog(program.id, sizeof(log), nullptr, log);
+        LogMsg("GPUDriverGL: program link failed: %s", log);
+        GLExt::DeleteProgram(program.id);
+        program.id = 0;
+        return false;
+    }
+
+    program.state = GLExt::GetUniformLocation(program.id, "State");
+    program.transform = GLExt::GetUniformLocation(program.id, "Transform");
+    program.scalar4 = GLExt::GetUniformLocation(program.id, "Scalar4");
+    program.vector = GLExt::GetUniformLocation(program.id, "Vector");
+    program.clip_size = GLExt::GetUniformLocation(program.id, "ClipSize");
+    program.clip = GLExt::GetUniformLocation(program.id, "Clip");
+
+    // Sampler units never change, set them once
+    GLExt::UseProgram(program.id);
+    GLExt::Uniform1i(GLExt::GetUniformLocation(program.id, "Texture1"), 0);
+    GLExt::Uniform1i(GLExt::GetUniformLocation(program.id, "Texture2"), 1);
+    GLExt::Uniform1i(GLExt::GetUniformLocation(program.id, "Texture3"), 2);
+    return true;
+}
+
+bool GPUDriverGL::LoadPrograms()
+{
+    if (programs_loaded_)
+        return true;
+    if (programs_failed_)
+        return false;
+
+    std::string fill_vert = shader_v2f_c4f_t2f_t2f_d28f_vert();
+    std::string fill_frag = shader_fill_frag();
+    std::string path_vert = shader_v2f_c4f_t2f_vert();
+    std::string path_frag = shader_fill_path_frag();
+
+    if (!CompileProgram(fill_program_, fill_vert.c_str(), fill_frag.c_str(), true) ||
+        !CompileProgram(path_program_, path_vert.c_str(), path_frag.c_str(), false))
+    {
+        // Don't retry every frame, accelerated views just stay blank
+        programs_failed_ = true;
+        return false;
+    }
+
+    programs_loaded_ = true;
+    return true;
+}
+
+void GPUDriverGL::BindRenderBuffer(uint32_t render_buffer_id, uint32_t width, uint32_t height)
+{
+    auto it = render_buffers_.find(render_buffer_id);
+    if (it == render_buffers_.end())
+        return;
+
+    RenderBufferEntry &entry = it->second;
+    if (entry.fbo == 0)
+    {
+        GLExt::GenFramebuffers(1, &entry.fbo);
+        GLExt::BindFramebuffer(GL_FRAMEBUFFER, entry.fbo);
+        GLExt::FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                                    GetGLTexture(entry.texture_id), 0);
+        if (GLExt::CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            LogMsg("GPUDriverGL: render buffer %u is incomplete", render_buffer_id);
+    }
+    else
+    {
+        GLExt::BindFramebuffer(GL_FRAMEBUFFER, entry.fbo);
+    }
+
+    glViewport(0, 0, width, height);
+}
+
+void GPUDriverGL::BindTexture(int unit, uint32_t texture_id)
+{
+    GLExt::ActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, GetGLTexture(texture_id));
+}
+
+void GPUDriverGL::SetUniforms(const Program &program, const GPUState &state)
+{
+    float time = std::chrono::duration<float>(std::chrono::steady_clock::now() - kStartTime).count();
+    float params[4] = {time, static_cast<float>(state.viewport_width),
+                       static_cast<float>(state.viewport_height), 1.0f};
+    GLExt::Uniform4fv(program.state, 1, params);
+
+    // Render buffers are sampled top-down like Ultralight's own texture coordinates
+    float mvp[16];
+    Projection(state.transform, static_cast<float>(state.viewport_width),
+               static_cast<float>(state.viewport_height), state.render_buffer_id != 0, mvp);
+    GLExt::UniformMatrix4fv(program.transform, 1, GL_FALSE, mvp);
+
+    GLExt::Uniform4fv(program.scalar4, 2, state.uniform_scalar);
+    GLExt::Uniform4fv(program.vector, 8, &state.uniform_vector[0].x);
+    GLExt::Uniform1ui(program.clip_size, state.clip_size);
+    GLExt::UniformMatrix4fv(program.clip, 8, GL_FALSE, state.clip[0].data);
+}
+
+void GPUDriverGL::ClearRenderBuffer(uint32_t render_buffer_id)
+{
+    auto it = render_buffers_.find(render_buffer_id);
+    if (it == render_buffers_.end())
+        return;
+
+    BindRenderBuffer(render_buffer_id, it->second.width, it->second.height);
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void GPUDriverGL::DrawGeometry(const Command &command)
+{
+    auto it = geometry_.find(command.geometry_id);
+    if (it == geometry_.end())
+        return;
+
+    const GPUState &state = command.gpu_state;
+    const Program &program = state.shader_type == ShaderType::Fill ? fill_program_ : path_program_;
+
+    BindRenderBuffer(state.render_buffer_id, state.viewport_width, state.viewport_height);
+    GLExt::UseProgram(program.id);
+    SetUniforms(program, state);
+
+    if (state.enable_texturing)
+    {
+        BindTexture(0, state.texture_1_id);
+        BindTexture(1, state.texture_2_id);
+        BindTexture(2, state.texture_3_id);
+    }
+
+    if (state.enable_scissor)
+    {
+        // Scissor rects are top-down, which matches the flipped render buffer projection
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(state.scissor_rect.left, state.scissor_rect.top,
+                  state.scissor_rect.width(), state.scissor_rect.height());
+    }
+    else
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+
+    if (state.enable_blend)
+        glEnable(GL_BLEND);
+    else
+        glDisable(GL_BLEND);
+
+    GLExt::BindVertexArray(it->second.vao);
+    glDrawElements(GL_TRIANGLES, command.indices_count, GL_UNSIGNED_INT,
+                   reinterpret_cast<const void *>(static_cast<size_t>(command.indices_offset) * sizeof(uint32_t)));
+}
+
+int GPUDriverGL::DrawCommandList()
+{
+    if (command_list_.empty())
+        return 0;
+
+    SavedState saved;
+    SaveState(saved);
+
+    if (!LoadPrograms())
+    {
+        command_list_.clear();
+        RestoreState(saved);
+        return 0;
+    }
+
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_SCISSOR_BIT | GL_VIEWPORT_BIT);
+
+    // X-Plane leaves fixed-function and depth state around that would still apply to our draws
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_ALPHA_TEST);
+    glDisable(GL_FRAMEBUFFER_SRGB);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);  // premultiplied alpha
+
+    int draws = 0;
+    for (const Command &command : command_list_)
+    {
+        if (command.command_type == CommandType::ClearRenderBuffer)
+        {
+            ClearRenderBuffer(command.gpu_state.render_buffer_id);
+        }
+        else
+        {
+            DrawGeometry(command);
+            draws++;
+        }
+    }
+    command_list_.clear();
+
+    glPopAttrib();
+    RestoreState(saved);
+    return draws;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <Ultralight/Ultralight.h>
+#include <Ultralight/platform/GPUDriver.h>
+
+#include "gl_ext.h"
+
+using namespace ultralight;
+
+/**
+ * @brief OpenGL 3.2 GPUDriver for accelerated views
+ *
+ * Accelerated views (ViewConfig::is_accelerated) are rasterized on the GPU
+ * with the GLSL 1.50 shaders shipped in the Ultralight SDK (shaders/glsl).
+ * Each view renders into an FBO texture, App::Draw() samples that texture
+ * directly through GetGLTexture() and the view's RenderTarget uv_coords.
+ *
+ * Resource updates (textures, geometry) happen inside Renderer::Render().
+ * Draw commands are queued by UpdateCommandList() and executed by
+ * DrawCommandList(), which the draw callback calls right after Render().
+ * Both run on X-Plane's GL context, so every piece of GL state touched is
+ * restored afterwards.
+ *
+ * Only depends on GL and Ultralight, not on XPLM, so it can be driven from a
+ * headless EGL context (see bench/headless_gl.h).
+ */
+class GPUDriverGL : public GPUDriver
+{
+public:
+    static GPUDriverGL &instance();
+
+    // Register with the Ultralight platform if the context supports GL 3.2,
+    // must happen before Renderer::Create() with a current GL context
+    bool Install();
+    bool IsInstalled() const { return installed_; }
+
+    // Execute the commands queued since the last call, returns the number of draws
+    int DrawCommandList();
+    bool HasCommandsPending() const { return !command_list_.empty(); }
+
+    // Native texture for a driver texture id (e.g. View::render_target().texture_id), 0 if unknown
+    GLuint GetGLTexture(uint32_t texture_id) const;
+
+    // Release every GL object, the driver must not be in use by a Renderer
+    void Shutdown();
+
+    // GPUDriver overrides
+    virtual void BeginSynchronize() override;
+    virtual void EndSynchronize() override;
+    virtual uint32_t NextTextureId() override { return next_texture_id_++; }
+    virtual void CreateTexture(uint32_t texture_id, RefPtr<Bitmap> bitmap) override;
+    virtual void UpdateTexture(uint32_t texture_id, RefPtr<Bitmap> bitmap) override;
+    virtual void DestroyTexture(uint32_t texture_id) override;
+    virtual uint32_t NextRenderBufferId() override { return next_render_buffer_id_++; }
+    virtual void CreateRenderBuffer(uint32_t render_buffer_id, const RenderBuffer &buffer) override;
+    virtual void DestroyRenderBuffer(uint32_t render_buffer_id) override;
+    virtual uint32_t NextGeometryId() override { return next_geometry_id_++; }
+    virtual void CreateGeometry(uint32_t geometry_id, const VertexBuffer &vertices,
+                                const IndexBuffer &indices) override;
+    virtual void UpdateGeometry(uint32_t geometry_id, const VertexBuffer &vertices,
+                                const IndexBuffer &indices) override;
+    virtual void DestroyGeometry(uint32_t geometry_id) override;
+    virtual void UpdateCommandList(const CommandList &list) override;
+
+private:
+    GPUDriverGL() = default;
+    GPUDriverGL(const GPUDriverGL &) = delete;
+    GPUDriverGL &operator=(const GPUDriverGL &) = delete;
+
+    struct TextureEntry {
+        GLuint tex = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    struct RenderBufferEntry {
+        GLuint fbo = 0;
+        uint32_t texture_id = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    struct GeometryEntry {
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ebo = 0;
+        VertexBufferFormat format = VertexBufferFormat::_2f_4ub_2f_2f_28f;
+    };
+
+    struct Program {
+        GLuint id = 0;
+        GLint state = -1;
+        GLint transform = -1;
+        GLint scalar4 = -1;
+        GLint vector = -1;
+        GLint clip_size = -1;
+        GLint clip = -1;
+    };
+
+    // Bindings X-Plane expects to find untouched after we return
+    struct SavedState {
+        GLint active_texture = 0;
+        GLint textures[3] = {0, 0, 0};
+        GLint array_buffer = 0;
+        GLint vertex_array = 0;
+        GLint unpack_buffer = 0;
+        GLint framebuffer = 0;
+        GLint program = 0;
+    };
+
+    bool LoadPrograms();
+    bool CompileProgram(Program &program, const char *vert, const char *frag, bool fill);
+    void SaveState(SavedState &state);
+    void RestoreState(const SavedState &state);
+    void UploadBitmap(RefPtr<Bitmap> bitmap);
+    void UploadGeometry(GeometryEntry &geometry, const VertexBuffer &vertices, const IndexBuffer &indices);
+    void BindRenderBuffer(uint32_t render_buffer_id, uint32_t width, uint32_t height);
+    void BindTexture(int unit, uint32_t texture_id);
+    void SetUniforms(const Program &program, const GPUState &state);
+    void ClearRenderBuffer(uint32_t render_buffer_id);
+    void DrawGeometry(const Command &command);
+
+    bool installed_ = false;
+    bool programs_loaded_ = false;
+    bool programs_failed_ = false;
+    Program fill_program_;
+    Program path_program_;
+
+    uint32_t next_texture_id_ = 1;
+    uint32_t next_render_buffer_id_ = 1;
+    uint32_t next_geometry_id_ = 1;
+    std::unordered_map<uint32_t, TextureEntry> textures_;
+    std::unordered_map<uint32_t, RenderBufferEntry> render_buffers_;
+    std::unordered_map<uint32_t, GeometryEntry> geometry_;
+    std::vector<Command> command_list_;
+
+    // Resource calls outside Begin/EndSynchronize save and restore state themselves
+    bool synchronizing_ = false;
+    SavedState sync_state_;
+};
@@ -1,8 +1,60 @@
 #include "js_bindings.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
 // Static member definitions
 std::unordered_map<std::string, XPLMDataRef> JSBindings::dataref_cache_;
 std::mutex JSBindings::cache_mutex_;
+DataRefTable JSBindings::handles_;
+std::vector<std::vector<JSBindings::DataRefSetEntry>> JSBindings::sets_;
+std::unordered_map<View*, std::vector<JSBindings::Subscription>> JSBindings::subscriptions_;
+int JSBindings::next_subscription_id_ = 1;
+std::vector<JSBindings::SnapshotSlot> JSBindings::snapshot_slots_;
+std::unordered_map<View*, JSBindings::SnapshotView> JSBindings::snapshot_views_;
+uint64_t JSBindings::snapshot_frame_ = 0;
+
+// Keeps the subscribe() callbacks in the page and leaves the dispatcher behind for
+// DispatchSubscriptions(), which fills dispatch.changes with (id, value) pairs
+const char* const JSBindings::kSubscribeShim = R"JS((function (dataref) {
+    var subscribe = dataref.subscribe, unsubscribe = dataref.unsubscribe;
+    var callbacks = {}, count = 0;
+
+    function dispatch(pairs) {
+        var changes = dispatch.changes;
+        for (var i = 0; i < pairs * 2; i += 2) {
+            var callback = callbacks[changes[i]];
+            if (!callback) continue;
+            try { callback(changes[i + 1]); }
+            catch (e) { console.error('XPlane.dataref.subscribe callback: ' + e); }
+        }
+    }
+    dispatch.changes = new Float64Array(16);
+    Object.defineProperty(window, '__skyscriptDataRefChanges', { value: dispatch, configurable: true });
+
+    dataref.subscribe = function (name, options, callback) {
+        if (typeof options === 'function') { callback = options; options = undefined; }
+        if (typeof callback !== 'function') {
+            console.error('XPlane.dataref.subscribe requires a callback');
+            return 0;
+        }
+        options = options || {};
+        var id = subscribe(name, options.hz || 0, options.epsilon || 0);
+        if (!id) return 0;
+        callbacks[id] = callback;
+        if (dispatch.changes.length < ++count * 2) dispatch.changes = new Float64Array(count * 4);
+        return id;
+    };
+
+    dataref.unsubscribe = function (id) {
+        if (!callbacks[id]) return false;
+        delete callbacks[id];
+        count--;
+        return unsubscribe(id);
+    };
+})(XPlane.dataref);)JS";
 
 // Scenery/Instance static members
 std::unordered_map<std::string, XPLMObjectRef> JSBindings::object_cache_;
@@ -26,6 +78,49 @@ XPLMDataRef JSBindings::GetCachedDataRef(const std::string& name) {
     return ref;
 }
 
+JSBindings::CacheStats JSBindings::GetCacheStats() {
+    CacheStats stats;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        stats.datarefs = dataref_cache_.size();
+    }
+    stats.handles = handles_.size();
+    stats.objects = object_cache_.size();
+    stats.instances = instance_cache_.size();
+    stats.probes = probe_cache_.size();
+    return stats;
+}
+
+JSBindings::CacheStats JSBindings::ReleaseAll() {
+    CacheStats released = GetCacheStats();
+
+    // Instances reference their objects, destroy them first
+    for (auto& [id, instance] : instance_cache_) {
+        XPLMDestroyInstance(instance);
+    }
+    instance_cache_.clear();
+
+    for (auto& [id, probe] : probe_cache_) {
+        XPLMDestroyProbe(probe);
+    }
+    probe_cache_.clear();
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    for (auto& [path, object] : object_cache_) {
+        XPLMUnloadObject(object);
+    }
+    object_cache_.clear();
+
+    // Aircraft plugins publish their own datarefs, look everything up again.
+    // Handles keep their number so pages holding them don't read the wrong dataref.
+    dataref_cache_.clear();
+    handles_.Release();
+
+    LogMsg("Released %zu datarefs, %zu objects, %zu instances, %zu probes",
+           released.datarefs, released.objects, released.instances, released.probes);
+    return released;
+}
+
 void JSBindings::BindToView(RefPtr<View> view) {
     RefPtr<JSContext> context = view->LockJSContext();
     SetJSContext(context->ctx());
@@ -58,6 +153,22 @@ void JSBindings::BindToView(RefPtr<View> view) {
     dataref["setFloatArray"] = JSCallbackWithRetval(JS_SetDatavf);
     dataref["setData"] = JSCallbackWithRetval(JS_SetDatab);
     
+    // Bulk reads
+    dataref["defineSet"] = JSCallbackWithRetval(JS_DefineSet);
+    dataref["readMany"] = JSCallbackWithRetval(JS_ReadMany);
+    
+    // Subscriptions belong to this view, wrapped by kSubscribeShim once XPlane is attached
+    View* raw_view = view.get();
+    dataref["subscribe"] = JSCallbackWithRetval([raw_view](const JSObject&, const JSArgs& args) {
+        return Subscribe(raw_view, args);
+    });
+    dataref["unsubscribe"] = JSCallbackWithRetval([raw_view](const JSObject&, const JSArgs& args) {
+        return Unsubscribe(raw_view, args);
+    });
+    dataref["snapshot"] = JSCallbackWithRetval([raw_view](const JSObject& thisObject, const JSArgs& args) {
+        return Snapshot(raw_view, thisObject, args);
+    });
+    
     // Attach dataref namespace to XPlane
     xplane["dataref"] = JSValue(static_cast<JSObjectRef>(dataref));
     
@@ -103,42 +214,127 @@ void JSBindings::BindToView(RefPtr<View> view) {
     
     xplane["graphics"] = JSValue(static_cast<JSObjectRef>(graphics));
     
+    // =========================================================================
+    // Create the app sub-namespace, filled in by the page (onSuspend) and by
+    // App::RestoreState (restoredState)
+    // =========================================================================
+    JSObject app;
+    
+    xplane["app"] = JSValue(static_cast<JSObjectRef>(app));
+    
     // Attach XPlane to global
     global["XPlane"] = JSValue(static_cast<JSObjectRef>(xplane));
     
-    LogMsg("JSBindings: Bound XPlane API (dataref, scenery, instance, graphics) to view");
+    // Subscriptions of the previous page are gone with it
+    subscriptions_.erase(view.get());
+    JSEval(kSubscribeShim);
+    
+    LogMsg("JSBindings: Bound XPlane API (dataref, scenery, instance, graphics, app) to view");
+}
+
+void* JSBindings::TypedArrayData(JSContextRef ctx, JSValueRef value, JSTypedArrayType type, size_t& length) {
+    if (JSValueGetTypedArrayType(ctx, value, nullptr) != type) {
+        return nullptr;
+    }
+    
+    // The bytes pointer is the start of the whole buffer, views may begin further in
+    JSObjectRef array = JSValueToObject(ctx, value, nullptr);
+    char* bytes = static_cast<char*>(JSObjectGetTypedArrayBytesPtr(ctx, array, nullptr));
+    if (!bytes) {
+        return nullptr;
+    }
+    length = JSObjectGetTypedArrayLength(ctx, array, nullptr);
+    return bytes + JSObjectGetTypedArrayByteOffset(ctx, array, nullptr);
+}
+
+JSObjectRef JSBindings::MakeTypedArray(JSContextRef ctx, JSTypedArrayType type, size_t length, void*& data) {
+    JSObjectRef array = JSObjectMakeTypedArray(ctx, type, length, nullptr);
+    data = nullptr;
+    if (array) {
+        data = TypedArrayData(ctx, array, type, length);
+    }
+    return array;
 }
 
 // =========================================================================
 // DataRef Lookup Functions
 // =========================================================================
 
-JSValue JSBindings::JS_FindDataRef(const JSObject& thisObject, const JSArgs& args) {
-    if (args.empty() || !args[0].IsString()) {
-        LogMsg("JSBindings: findDataRef requires a string argument");
-        return JSValue();
+// Seconds on the steady clock, paces the lookups of datarefs that don't exist yet
+static double SteadyNow() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int JSBindings::GetDataRefHandle(const std::string& name, bool pending) {
+    return handles_.Find(name, pending, SteadyNow());
+}
+
+XPLMDataRef JSBindings::HandleDataRef(int handle) {
+    return handles_.Resolve(handle, SteadyNow());
+}
+
+XPLMDataRef JSBindings::ResolveDataRef(const JSArgs& args, const char* function) {
+    if (args.empty()) {
+        LogMsg("JSBindings: %s requires a dataref name or handle", function);
+        return nullptr;
     }
-    
-    String name = args[0].ToString();
+
+    // Handle from find(): a table index, no string conversion, hashing or locking
+    JSValue arg = args[0];
+    if (arg.IsNumber()) {
+        int handle = static_cast<int>(arg.ToNumber());
+        XPLMDataRef ref = HandleDataRef(handle);
+        if (!ref) {
+            LogMsg("JSBindings: %s: invalid dataref handle %d", function, handle);
+        }
+        return ref;
+    }
+
+    if (!arg.IsString()) {
+        LogMsg("JSBindings: %s requires a dataref name or handle", function);
+        return nullptr;
+    }
+
+    String name = arg.ToString();
     std::string name_str = name.utf8().data();
-    
     XPLMDataRef ref = GetCachedDataRef(name_str);
-    if (ref) {
-        return JSValue(true);
+    if (!ref) {
+        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
     }
-    return JSValue();
+    return ref;
 }
 
-JSValue JSBindings::JS_CanWriteDataRef(const JSObject& thisObject, const JSArgs& args) {
+std::string JSBindings::DataRefName(const JSValue& arg) {
+    if (arg.IsNumber()) {
+        return handles_.Name(static_cast<int>(arg.ToNumber()));
+    }
+    String name = arg.ToString();
+    return name.utf8().data();
+}
+
+// =========================================================================
+// DataRef Lookup Functions
+// =========================================================================
+
+JSValue JSBindings::JS_FindDataRef(const JSObject& thisObject, const JSArgs& args) {
     if (args.empty() || !args[0].IsString()) {
-        LogMsg("JSBindings: canWriteDataRef requires a string argument");
-        return JSValue(false);
+        LogMsg("JSBindings: findDataRef requires a string argument");
+        return JSValue(JSValueNullTag());
     }
     
     String name = args[0].ToString();
     std::string name_str = name.utf8().data();
     
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    int handle = GetDataRefHandle(name_str);
+    if (handle) {
+        return JSValue(handle);
+    }
+    // find(name): DataRefHandle | null, a missing dataref is null rather than undefined
+    return JSValue(JSValueNullTag());
+}
+
+JSValue JSBindings::JS_CanWriteDataRef(const JSObject& thisObject, const JSArgs& args) {
+    XPLMDataRef ref = ResolveDataRef(args, "canWrite");
     if (!ref) {
         return JSValue(false);
     }
@@ -147,15 +343,7 @@ JSValue JSBindings::JS_CanWriteDataRef(const JSObject& thisObject, const JSArgs&
 }
 
 JSValue JSBindings::JS_GetDataRefTypes(const JSObject& thisObject, const JSArgs& args) {
-    if (args.empty() || !args[0].IsString()) {
-        LogMsg("JSBindings: getDataRefTypes requires a string argument");
-        return JSValue();
-    }
-    
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "getTypes");
     if (!ref) {
         return JSValue();
     }
@@ -178,17 +366,8 @@ JSValue JSBindings::JS_GetDataRefTypes(const JSObject& thisObject, const JSArgs&
 // =========================================================================
 
 JSValue JSBindings::JS_GetDatai(const JSObject& thisObject, const JSArgs& args) {
-    if (args.empty() || !args[0].IsString()) {
-        LogMsg("JSBindings: getInt requires a string argument");
-        return JSValue(0);
-    }
-    
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "getInt");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue(0);
     }
     
@@ -196,17 +375,8 @@ JSValue JSBindings::JS_GetDatai(const JSObject& thisObject, const JSArgs& args)
 }
 
 JSValue JSBindings::JS_GetDataf(const JSObject& thisObject, const JSArgs& args) {
-    if (args.empty() || !args[0].IsString()) {
-        LogMsg("JSBindings: getFloat requires a string argument");
-        return JSValue(0.0);
-    }
-    
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "getFloat");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue(0.0);
     }
     
@@ -214,17 +384,8 @@ JSValue JSBindings::JS_GetDataf(const JSObject& thisObject, const JSArgs& args)
 }
 
 JSValue JSBindings::JS_GetDatad(const JSObject& thisObject, const JSArgs& args) {
-    if (args.empty() || !args[0].IsString()) {
-        LogMsg("JSBindings: getDouble requires a string argument");
-        return JSValue(0.0);
-    }
-    
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "getDouble");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue(0.0);
     }
     
@@ -232,22 +393,29 @@ JSValue JSBindings::JS_GetDatad(const JSObject& thisObject, const JSArgs& args)
 }
 
 JSValue JSBindings::JS_GetDatavi(const JSObject& thisObject, const JSArgs& args) {
-    if (args.empty() || !args[0].IsString()) {
-        LogMsg("JSBindings: getIntArray requires a string argument");
-        return JSValue();
-    }
-    
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "getIntArray");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue();
     }
     
     // Get array size
     int size = XPLMGetDatavi(ref, nullptr, 0, 0);
+    JSContextRef ctx = thisObject.context();
+    
+    // Caller-supplied Int32Array: read straight into it, returns the element count
+    size_t out_length = 0;
+    void* out = args.size() > 1 ? TypedArrayData(ctx, args[1], kJSTypedArrayTypeInt32Array, out_length) : nullptr;
+    if (out) {
+        int offset = args.size() > 2 && args[2].IsNumber() ? static_cast<int>(args[2].ToNumber()) : 0;
+        if (offset < 0) offset = 0;
+        int count = std::min(static_cast<int>(out_length), size - offset);
+        if (count <= 0) {
+            return JSValue(0);
+        }
+        XPLMGetDatavi(ref, static_cast<int*>(out), offset, count);
+        return JSValue(count);
+    }
+    
     if (size <= 0) {
         return JSValue();
     }
@@ -267,37 +435,45 @@ JSValue JSBindings::JS_GetDatavi(const JSObject& thisObject, const JSArgs& args)
     if (offset < 0) offset = 0;
     if (offset >= size) return JSValue();
     if (count > size - offset) count = size - offset;
+    if (count < 0) count = 0;
     
-    // Read the data
-    std::vector<int> values(count);
-    XPLMGetDatavi(ref, values.data(), offset, count);
-    
-    // Convert to JS array
-    JSArray result;
-    for (int i = 0; i < count; i++) {
-        result.push(JSValue(values[i]));
+    // Read into the new typed array's own storage, no per-element JSValues
+    void* data = nullptr;
+    JSObjectRef result = MakeTypedArray(ctx, kJSTypedArrayTypeInt32Array, count, data);
+    if (!result) {
+        return JSValue();
+    }
+    if (count > 0) {
+        XPLMGetDatavi(ref, static_cast<int*>(data), offset, count);
     }
     
-    return JSValue(static_cast<JSObjectRef>(result));
+    return JSValue(result);
 }
 
 JSValue JSBindings::JS_GetDatavf(const JSObject& thisObject, const JSArgs& args) {
-    if (args.empty() || !args[0].IsString()) {
-        LogMsg("JSBindings: getFloatArray requires a string argument");
-        return JSValue();
-    }
-    
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "getFloatArray");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue();
     }
     
     // Get array size
     int size = XPLMGetDatavf(ref, nullptr, 0, 0);
+    JSContextRef ctx = thisObject.context();
+    
+    // Caller-supplied Float32Array: read straight into it, returns the element count
+    size_t out_length = 0;
+    void* out = args.size() > 1 ? TypedArrayData(ctx, args[1], kJSTypedArrayTypeFloat32Array, out_length) : nullptr;
+    if (out) {
+        int offset = args.size() > 2 && args[2].IsNumber() ? static_cast<int>(args[2].ToNumber()) : 0;
+        if (offset < 0) offset = 0;
+        int count = std::min(static_cast<int>(out_length), size - offset);
+        if (count <= 0) {
+            return JSValue(0);
+        }
+        XPLMGetDatavf(ref, static_cast<float*>(out), offset, count);
+        return JSValue(count);
+    }
+    
     if (size <= 0) {
         return JSValue();
     }
@@ -317,32 +493,24 @@ JSValue JSBindings::JS_GetDatavf(const JSObject& thisObject, const JSArgs& args)
     if (offset < 0) offset = 0;
     if (offset >= size) return JSValue();
     if (count > size - offset) count = size - offset;
+    if (count < 0) count = 0;
     
-    // Read the data
-    std::vector<float> values(count);
-    XPLMGetDatavf(ref, values.data(), offset, count);
-    
-    // Convert to JS array
-    JSArray result;
-    for (int i = 0; i < count; i++) {
-        result.push(JSValue(static_cast<double>(values[i])));
+    // Read into the new typed array's own storage, no per-element JSValues
+    void* data = nullptr;
+    JSObjectRef result = MakeTypedArray(ctx, kJSTypedArrayTypeFloat32Array, count, data);
+    if (!result) {
+        return JSValue();
+    }
+    if (count > 0) {
+        XPLMGetDatavf(ref, static_cast<float*>(data), offset, count);
     }
     
-    return JSValue(static_cast<JSObjectRef>(result));
+    return JSValue(result);
 }
 
 JSValue JSBindings::JS_GetDatab(const JSObject& thisObject, const JSArgs& args) {
-    if (args.empty() || !args[0].IsString()) {
-        LogMsg("JSBindings: getData requires a string argument");
-        return JSValue("");
-    }
-    
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "getData");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue("");
     }
     
@@ -380,97 +548,79 @@ JSValue JSBindings::JS_GetDatab(const JSObject& thisObject, const JSArgs& args)
 // =========================================================================
 
 JSValue JSBindings::JS_SetDatai(const JSObject& thisObject, const JSArgs& args) {
-    if (args.size() < 2 || !args[0].IsString() || !args[1].IsNumber()) {
-        LogMsg("JSBindings: setInt requires (string, number) arguments");
+    if (args.size() < 2 || !args[1].IsNumber()) {
+        LogMsg("JSBindings: setInt requires (dataref, number) arguments");
         return JSValue(false);
     }
     
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    int value = static_cast<int>(args[1].ToNumber());
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "setInt");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue(false);
     }
     
     if (!XPLMCanWriteDataRef(ref)) {
-        LogMsg("JSBindings: dataref is read-only: %s", name_str.c_str());
+        LogMsg("JSBindings: dataref is read-only: %s", DataRefName(args[0]).c_str());
         return JSValue(false);
     }
     
-    XPLMSetDatai(ref, value);
+    XPLMSetDatai(ref, static_cast<int>(args[1].ToNumber()));
     return JSValue(true);
 }
 
 JSValue JSBindings::JS_SetDataf(const JSObject& thisObject, const JSArgs& args) {
-    if (args.size() < 2 || !args[0].IsString() || !args[1].IsNumber()) {
-        LogMsg("JSBindings: setFloat requires (string, number) arguments");
+    if (args.size() < 2 || !args[1].IsNumber()) {
+        LogMsg("JSBindings: setFloat requires (dataref, number) arguments");
         return JSValue(false);
     }
     
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    float value = static_cast<float>(args[1].ToNumber());
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "setFloat");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue(false);
     }
     
     if (!XPLMCanWriteDataRef(ref)) {
-        LogMsg("JSBindings: dataref is read-only: %s", name_str.c_str());
+        LogMsg("JSBindings: dataref is read-only: %s", DataRefName(args[0]).c_str());
         return JSValue(false);
     }
     
-    XPLMSetDataf(ref, value);
+    XPLMSetDataf(ref, static_cast<float>(args[1].ToNumber()));
     return JSValue(true);
 }
 
 JSValue JSBindings::JS_SetDatad(const JSObject& thisObject, const JSArgs& args) {
-    if (args.size() < 2 || !args[0].IsString() || !args[1].IsNumber()) {
-        LogMsg("JSBindings: setDouble requires (string, number) arguments");
+    if (args.size() < 2 || !args[1].IsNumber()) {
+        LogMsg("JSBindings: setDouble requires (dataref, number) arguments");
         return JSValue(false);
     }
     
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    double value = args[1].ToNumber();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "setDouble");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue(false);
     }
     
     if (!XPLMCanWriteDataRef(ref)) {
-        LogMsg("JSBindings: dataref is read-only: %s", name_str.c_str());
+        LogMsg("JSBindings: dataref is read-only: %s", DataRefName(args[0]).c_str());
         return JSValue(false);
     }
     
-    XPLMSetDatad(ref, value);
+    XPLMSetDatad(ref, args[1].ToNumber());
     return JSValue(true);
 }
 
 JSValue JSBindings::JS_SetDatavi(const JSObject& thisObject, const JSArgs& args) {
-    if (args.size() < 2 || !args[0].IsString() || !args[1].IsArray()) {
-        LogMsg("JSBindings: setIntArray requires (string, array) arguments");
+    JSContextRef ctx = thisObject.context();
+    if (args.size() < 2 || (!args[1].IsArray() && JSValueGetTypedArrayType(ctx, args[1], nullptr) == kJSTypedArrayTypeNone)) {
+        LogMsg("JSBindings: setIntArray requires (dataref, array) arguments");
         return JSValue(false);
     }
     
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "setIntArray");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue(false);
     }
     
     if (!XPLMCanWriteDataRef(ref)) {
-        LogMsg("JSBindings: dataref is read-only: %s", name_str.c_str());
+        LogMsg("JSBindings: dataref is read-only: %s", DataRefName(args[0]).c_str());
         return JSValue(false);
     }
     
@@ -480,11 +630,21 @@ JSValue JSBindings::JS_SetDatavi(const JSObject& thisObject, const JSArgs& args)
         offset = static_cast<int>(args[2].ToNumber());
     }
     
-    // Convert JS array to int array
-    JSArray arr = args[1].ToArray();
+    // Int32Array: hand its storage to X-Plane as is
+    size_t length = 0;
+    void* data = TypedArrayData(ctx, args[1], kJSTypedArrayTypeInt32Array, length);
+    if (data) {
+        XPLMSetDatavi(ref, static_cast<int*>(data), offset, static_cast<int>(length));
+        return JSValue(true);
+    }
+    
+    // Plain arrays and other typed arrays are converted element by element
+    JSObjectRef arr = JSValueToObject(ctx, args[1], nullptr);
+    unsigned count = static_cast<unsigned>(JSValueToNumber(ctx, JSObjectGetProperty(ctx, arr, JSString("length"), nullptr), nullptr));
     std::vector<int> values;
-    for (unsigned i = 0; i < arr.length(); i++) {
-        values.push_back(static_cast<int>(arr[i].ToNumber()));
+    values.reserve(count);
+    for (unsigned i = 0; i < count; i++) {
+        values.push_back(static_cast<int>(JSValueToNumber(ctx, JSObjectGetPropertyAtIndex(ctx, arr, i, nullptr), nullptr)));
     }
     
     XPLMSetDatavi(ref, values.data(), offset, static_cast<int>(values.size()));
@@ -492,22 +652,19 @@ JSValue JSBindings::JS_SetDatavi(const JSObject& thisObject, const JSArgs& args)
 }
 
 JSValue JSBindings::JS_SetDatavf(const JSObject& thisObject, const JSArgs& args) {
-    if (args.size() < 2 || !args[0].IsString() || !args[1].IsArray()) {
-        LogMsg("JSBindings: setFloatArray requires (string, array) arguments");
+    JSContextRef ctx = thisObject.context();
+    if (args.size() < 2 || (!args[1].IsArray() && JSValueGetTypedArrayType(ctx, args[1], nullptr) == kJSTypedArrayTypeNone)) {
+        LogMsg("JSBindings: setFloatArray requires (dataref, array) arguments");
         return JSValue(false);
     }
     
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "setFloatArray");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue(false);
     }
     
     if (!XPLMCanWriteDataRef(ref)) {
-        LogMsg("JSBindings: dataref is read-only: %s", name_str.c_str());
+        LogMsg("JSBindings: dataref is read-only: %s", DataRefName(args[0]).c_str());
         return JSValue(false);
     }
     
@@ -517,11 +674,21 @@ JSValue JSBindings::JS_SetDatavf(const JSObject& thisObject, const JSArgs& args)
         offset = static_cast<int>(args[2].ToNumber());
     }
     
-    // Convert JS array to float array
-    JSArray arr = args[1].ToArray();
+    // Float32Array: hand its storage to X-Plane as is
+    size_t length = 0;
+    void* data = TypedArrayData(ctx, args[1], kJSTypedArrayTypeFloat32Array, length);
+    if (data) {
+        XPLMSetDatavf(ref, static_cast<float*>(data), offset, static_cast<int>(length));
+        return JSValue(true);
+    }
+    
+    // Plain arrays and other typed arrays are converted element by element
+    JSObjectRef arr = JSValueToObject(ctx, args[1], nullptr);
+    unsigned count = static_cast<unsigned>(JSValueToNumber(ctx, JSObjectGetProperty(ctx, arr, JSString("length"), nullptr), nullptr));
     std::vector<float> values;
-    for (unsigned i = 0; i < arr.length(); i++) {
-        values.push_back(static_cast<float>(arr[i].ToNumber()));
+    values.reserve(count);
+    for (unsigned i = 0; i < count; i++) {
+        values.push_back(static_cast<float>(JSValueToNumber(ctx, JSObjectGetPropertyAtIndex(ctx, arr, i, nullptr), nullptr)));
     }
     
     XPLMSetDatavf(ref, values.data(), offset, static_cast<int>(values.size()));
@@ -529,28 +696,24 @@ JSValue JSBindings::JS_SetDatavf(const JSObject& thisObject, const JSArgs& args)
 }
 
 JSValue JSBindings::JS_SetDatab(const JSObject& thisObject, const JSArgs& args) {
-    if (args.size() < 2 || !args[0].IsString() || !args[1].IsString()) {
-        LogMsg("JSBindings: setData requires (string, string) arguments");
+    if (args.size() < 2 || !args[1].IsString()) {
+        LogMsg("JSBindings: setData requires (dataref, string) arguments");
         return JSValue(false);
     }
     
-    String name = args[0].ToString();
-    std::string name_str = name.utf8().data();
-    
-    String value = args[1].ToString();
-    std::string value_str = value.utf8().data();
-    
-    XPLMDataRef ref = GetCachedDataRef(name_str);
+    XPLMDataRef ref = ResolveDataRef(args, "setData");
     if (!ref) {
-        LogMsg("JSBindings: dataref not found: %s", name_str.c_str());
         return JSValue(false);
     }
     
     if (!XPLMCanWriteDataRef(ref)) {
-        LogMsg("JSBindings: dataref is read-only: %s", name_str.c_str());
+        LogMsg("JSBindings: dataref is read-only: %s", DataRefName(args[0]).c_str());
         return JSValue(false);
     }
     
+    String value = args[1].ToString();
+    std::string value_str = value.utf8().data();
+    
     // Parse optional offset
     int offset = 0;
     if (args.size() > 2 && args[2].IsNumber()) {
@@ -561,6 +724,390 @@ JSValue JSBindings::JS_SetDatab(const JSObject& thisObject, const JSArgs& args)
     return JSValue(true);
 }
 
+// =========================================================================
+// Bulk Reads
+// =========================================================================
+
+XPLMDataTypeID JSBindings::PickReadType(XPLMDataRef ref, bool element) {
+    XPLMDataTypeID types = XPLMGetDataRefTypes(ref);
+    if (element) {
+        if (types & xplmType_FloatArray) return xplmType_FloatArray;
+        if (types & xplmType_IntArray) return xplmType_IntArray;
+        return xplmType_Unknown;
+    }
+    if (types & xplmType_Double) return xplmType_Double;
+    if (types & xplmType_Float) return xplmType_Float;
+    if (types & xplmType_Int) return xplmType_Int;
+    return xplmType_Unknown;
+}
+
+JSBindings::DataRefSetEntry JSBindings::ParseSetEntry(const JSValue& item) {
+    DataRefSetEntry entry;
+    if (item.IsNumber()) {
+        entry.handle = static_cast<int>(item.ToNumber());
+    } else if (item.IsString()) {
+        // "path[3]" reads one element of an array dataref
+        String name = item.ToString();
+        std::string name_str = name.utf8().data();
+        size_t bracket = name_str.find('[');
+        if (bracket != std::string::npos && name_str.back() == ']') {
+            entry.index = std::atoi(name_str.c_str() + bracket + 1);
+            name_str.resize(bracket);
+        }
+        entry.handle = GetDataRefHandle(name_str, true);
+    }
+    return entry;
+}
+
+double JSBindings::ReadSetEntry(DataRefSetEntry& entry) {
+    // Type is picked once per resolved ref, again only after ReleaseAll()
+    XPLMDataRef ref = HandleDataRef(entry.handle);
+    if (ref != entry.ref) {
+        entry.ref = ref;
+        entry.type = ref ? PickReadType(ref, entry.index >= 0) : xplmType_Unknown;
+        if (ref) {
+            entry.warned = false;
+        }
+    }
+    if (!ref && !entry.warned) {
+        LogMsg("JSBindings: dataref %s not found, reads NaN until it is registered",
+               handles_.Name(entry.handle).c_str());
+        entry.warned = true;
+    }
+    
+    switch (entry.type) {
+    case xplmType_Double:
+        return XPLMGetDatad(ref);
+    case xplmType_Float:
+        return XPLMGetDataf(ref);
+    case xplmType_Int:
+        return XPLMGetDatai(ref);
+    case xplmType_FloatArray: {
+        float value = 0.0f;
+        return XPLMGetDatavf(ref, &value, entry.index, 1) == 1 ? value : NAN;
+    }
+    case xplmType_IntArray: {
+        int value = 0;
+        return XPLMGetDatavi(ref, &value, entry.index, 1) == 1 ? value : NAN;
+    }
+    default:
+        return NAN;
+    }
+}
+
+JSValue JSBindings::JS_DefineSet(const JSObject& thisObject, const JSArgs& args) {
+    if (args.empty() || !args[0].IsArray()) {
+        LogMsg("JSBindings: defineSet requires an array of datarefs");
+        return JSValue();
+    }
+    
+    JSArray list = args[0].ToArray();
+    std::vector<DataRefSetEntry> entries;
+    entries.reserve(list.length());
+    for (unsigned i = 0; i < list.length(); i++) {
+        entries.push_back(ParseSetEntry(list[i]));
+    }
+    
+    // Pages define the same sets again after every reload, hand out the existing one
+    for (size_t id = 0; id < sets_.size(); id++) {
+        if (sets_[id].size() == entries.size() &&
+            std::equal(entries.begin(), entries.end(), sets_[id].begin(),
+                       [](const DataRefSetEntry& a, const DataRefSetEntry& b) {
+                           return a.handle == b.handle && a.index == b.index;
+                       })) {
+            return JSValue(static_cast<int>(id + 1));
+        }
+    }
+    
+    sets_.push_back(std::move(entries));
+    return JSValue(static_cast<int>(sets_.size()));
+}
+
+JSValue JSBindings::JS_ReadMany(const JSObject& thisObject, const JSArgs& args) {
+    JSContextRef ctx = thisObject.context();
+    size_t length = 0;
+    double* out = nullptr;
+    if (args.size() >= 2 && args[0].IsNumber()) {
+        out = static_cast<double*>(TypedArrayData(ctx, args[1], kJSTypedArrayTypeFloat64Array, length));
+    }
+    if (!out) {
+        LogMsg("JSBindings: readMany requires (set, Float64Array) arguments");
+        return JSValue(0);
+    }
+    
+    int id = static_cast<int>(args[0].ToNumber());
+    if (id < 1 || id > static_cast<int>(sets_.size())) {
+        LogMsg("JSBindings: readMany: invalid set %d", id);
+        return JSValue(0);
+    }
+    
+    std::vector<DataRefSetEntry>& entries = sets_[id - 1];
+    size_t count = std::min(length, entries.size());
+    for (size_t i = 0; i < count; i++) {
+        out[i] = ReadSetEntry(entries[i]);
+    }
+    
+    return JSValue(static_cast<int>(count));
+}
+
+// =========================================================================
+// Subscriptions
+// =========================================================================
+
+JSValue JSBindings::Subscribe(View* view, const JSArgs& args) {
+    if (args.empty() || (!args[0].IsNumber() && !args[0].IsString())) {
+        LogMsg("JSBindings: subscribe requires a dataref");
+        return JSValue(0);
+    }
+    
+    Subscription sub;
+    sub.entry = ParseSetEntry(args[0]);
+    if (!handles_.Valid(sub.entry.handle)) {
+        LogMsg("JSBindings: subscribe: invalid dataref handle %s", DataRefName(args[0]).c_str());
+        return JSValue(0);
+    }
+    double hz = args.size() > 1 && args[1].IsNumber() ? args[1].ToNumber() : 0.0;
+    sub.period = hz > 0.0 ? 1.0 / hz : 0.0;
+    sub.epsilon = args.size() > 2 && args[2].IsNumber() ? std::max(args[2].ToNumber(), 0.0) : 0.0;
+    sub.id = next_subscription_id_++;
+    
+    subscriptions_[view].push_back(sub);
+    return JSValue(sub.id);
+}
+
+JSValue JSBindings::Unsubscribe(View* view, const JSArgs& args) {
+    auto it = subscriptions_.find(view);
+    if (args.empty() || !args[0].IsNumber() || it == subscriptions_.end()) {
+        return JSValue(false);
+    }
+    
+    int id = static_cast<int>(args[0].ToNumber());
+    std::vector<Subscription>& subs = it->second;
+    auto sub = std::find_if(subs.begin(), subs.end(), [id](const Subscription& s) { return s.id == id; });
+    if (sub == subs.end()) {
+        return JSValue(false);
+    }
+    subs.erase(sub);
+    return JSValue(true);
+}
+
+void JSBindings::UnbindView(View* view) {
+    subscriptions_.erase(view);
+    
+    auto it = snapshot_views_.find(view);
+    if (it != snapshot_views_.end()) {
+        std::vector<int> slots = it->second.slots;
+        ReleaseSnapshotSlots(view, slots);
+        snapshot_views_.erase(view);
+    }
+}
+
+bool JSBindings::DispatchSubscriptions(View* view, double now) {
+    auto it = subscriptions_.find(view);
+    if (it == subscriptions_.end()) {
+        return false;
+    }
+    
+    // A value that doesn't resolve (NaN) is not delivered until it does
+    size_t pending = 0;
+    for (Subscription& sub : it->second) {
+        if (now >= sub.next_sample) {
+            sub.next_sample = now + sub.period;
+            double value = ReadSetEntry(sub.entry);
+            if (!std::isnan(value) && !(std::fabs(value - sub.value) <= sub.epsilon)) {
+                sub.value = value;
+                sub.pending = true;
+            }
+        }
+        if (sub.pending) {
+            pending++;
+        }
+    }
+    if (pending == 0) {
+        return false;
+    }
+    
+    RefPtr<JSContext> context = view->LockJSContext();
+    JSContextRef ctx = context->ctx();
+    JSValueRef dispatch = JSObjectGetProperty(ctx, JSContextGetGlobalObject(ctx), JSString("__skyscriptDataRefChanges"), nullptr);
+    if (!JSValueIsObject(ctx, dispatch)) {
+        return false;  // page is still loading, keep the changes for the next frame
+    }
+    JSObjectRef dispatch_object = JSValueToObject(ctx, dispatch, nullptr);
+    size_t length = 0;
+    double* changes = static_cast<double*>(TypedArrayData(ctx, JSObjectGetProperty(ctx, dispatch_object, JSString("changes"), nullptr),
+                                                          kJSTypedArrayTypeFloat64Array, length));
+    if (!changes) {
+        return false;
+    }
+    
+    size_t pairs = 0;
+    for (Subscription& sub : it->second) {
+        if (sub.pending && (pairs + 1) * 2 <= length) {
+            changes[pairs * 2] = sub.id;
+            changes[pairs * 2 + 1] = sub.value;
+            sub.pending = false;
+            pairs++;
+        }
+    }
+    
+    // Callbacks may subscribe or unsubscribe, the subscription list is not touched after this point
+    JSValueRef arg = JSValueMakeNumber(ctx, static_cast<double>(pairs));
+    JSValueRef exception = nullptr;
+    JSObjectCallAsFunction(ctx, dispatch_object, nullptr, 1, &arg, &exception);
+    if (exception) {
+        LogMsg("JSBindings: subscription dispatch threw");
+    }
+    return true;
+}
+
+// =========================================================================
+// Snapshot
+// =========================================================================
+
+int JSBindings::AcquireSnapshotSlot(View* view, const DataRefSetEntry& entry, bool& added) {
+    added = false;
+    int slot = -1;
+    for (size_t i = 0; i < snapshot_slots_.size(); i++) {
+        const SnapshotSlot& s = snapshot_slots_[i];
+        if (s.refs > 0 && s.entry.handle == entry.handle && s.entry.index == entry.index) {
+            slot = static_cast<int>(i);
+            break;
+        }
+        if (s.refs == 0 && slot < 0) {
+            slot = static_cast<int>(i);  // free, used unless the entry is found further on
+        }
+    }
+    
+    if (slot < 0 || snapshot_slots_[slot].refs == 0) {
+        if (slot < 0) {
+            if (snapshot_slots_.size() >= kMaxSnapshotSlots) {
+                return -1;
+            }
+            slot = static_cast<int>(snapshot_slots_.size());
+            snapshot_slots_.emplace_back();
+        }
+        // Valid right away, not only after the next flight loop
+        snapshot_slots_[slot].entry = entry;
+        snapshot_slots_[slot].value = ReadSetEntry(snapshot_slots_[slot].entry);
+    }
+    
+    std::vector<int>& held = snapshot_views_[view].slots;
+    if (std::find(held.begin(), held.end(), slot) == held.end()) {
+        held.push_back(slot);
+        snapshot_slots_[slot].refs++;
+        added = true;
+    }
+    return slot;
+}
+
+void JSBindings::ReleaseSnapshotSlots(View* view, const std::vector<int>& slots) {
+    auto it = snapshot_views_.find(view);
+    if (it == snapshot_views_.end()) {
+        return;
+    }
+    
+    std::vector<int>& held = it->second.slots;
+    for (int slot : slots) {
+        auto pos = std::find(held.begin(), held.end(), slot);
+        if (pos != held.end()) {
+            held.erase(pos);
+            snapshot_slots_[slot].refs--;
+        }
+    }
+    if (held.empty() && it->second.buffers.empty()) {
+        snapshot_views_.erase(it);
+    }
+    while (!snapshot_slots_.empty() && snapshot_slots_.back().refs == 0) {
+        snapshot_slots_.pop_back();
+    }
+}
+
+void JSBindings::SampleSnapshot() {
+    if (snapshot_views_.empty()) {
+        return;
+    }
+    for (SnapshotSlot& slot : snapshot_slots_) {
+        if (slot.refs > 0) {
+            slot.value = ReadSetEntry(slot.entry);
+        }
+    }
+    
+    // One sample per dataref, copied into every buffer that declared it
+    double frame = static_cast<double>(++snapshot_frame_);
+    for (auto& [view, state] : snapshot_views_) {
+        std::vector<SnapshotBuffer>& buffers = state.buffers;
+        // Buffers the page no longer references were collected, only our reference is left
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                     [](const SnapshotBuffer& b) { return b.data.use_count() == 1; }),
+                      buffers.end());
+        for (SnapshotBuffer& buffer : buffers) {
+            double* data = buffer.data->data();
+            data[0] = frame;
+            for (size_t i = 0; i < buffer.slots.size(); i++) {
+                data[i + 1] = snapshot_slots_[buffer.slots[i]].value;
+            }
+        }
+    }
+}
+
+JSValue JSBindings::Snapshot(View* view, const JSObject& thisObject, const JSArgs& args) {
+    if (args.empty() || !args[0].IsObject() || args[0].IsArray()) {
+        LogMsg("JSBindings: snapshot requires a {name: dataref} object");
+        return JSValue(JSValueNullTag());
+    }
+    
+    JSContextRef ctx = thisObject.context();
+    JSObject schema = args[0].ToObject();
+    JSObject offsets;
+    SnapshotBuffer snapshot;
+    std::vector<int> acquired;  // newly held by this view, given back if the declaration fails
+    JSPropertyNameArrayRef names = JSObjectCopyPropertyNames(ctx, schema);
+    size_t count = JSPropertyNameArrayGetCount(names);
+    bool full = false;
+    for (size_t i = 0; i < count && !full; i++) {
+        JSString name(JSPropertyNameArrayGetNameAtIndex(names, i));
+        JSValue item = schema[name];
+        DataRefSetEntry entry = ParseSetEntry(item);
+        bool added = false;
+        int slot = AcquireSnapshotSlot(view, entry, added);
+        full = slot < 0;
+        if (added) {
+            acquired.push_back(slot);
+        }
+        snapshot.slots.push_back(slot);
+        offsets[name] = JSValue(static_cast<int>(snapshot.slots.size()));
+    }
+    JSPropertyNameArrayRelease(names);
+    if (full) {
+        ReleaseSnapshotSlots(view, acquired);
+        LogMsg("JSBindings: snapshot: all %zu slots are used", kMaxSnapshotSlots);
+        return JSValue(JSValueNullTag());
+    }
+    
+    snapshot.data = std::make_shared<std::vector<double>>(snapshot.slots.size() + 1);
+    std::vector<double>& data = *snapshot.data;
+    data[0] = static_cast<double>(snapshot_frame_);
+    for (size_t i = 0; i < snapshot.slots.size(); i++) {
+        data[i + 1] = snapshot_slots_[snapshot.slots[i]].value;
+    }
+    
+    // The page's ArrayBuffer keeps its own reference, SampleSnapshot() drops ours once it is collected
+    auto* owner = new std::shared_ptr<std::vector<double>>(snapshot.data);
+    JSObjectRef buffer = JSObjectMakeArrayBufferWithBytesNoCopy(
+        ctx, data.data(), data.size() * sizeof(double),
+        [](void*, void* context) { delete static_cast<std::shared_ptr<std::vector<double>>*>(context); },
+        owner, nullptr);
+    JSObjectRef values = JSObjectMakeTypedArrayWithArrayBuffer(ctx, kJSTypedArrayTypeFloat64Array, buffer, nullptr);
+    snapshot_views_[view].buffers.push_back(std::move(snapshot));
+    
+    JSObject result;
+    result["buffer"] = JSValue(buffer);
+    result["values"] = JSValue(values);
+    result["offsets"] = JSValue(static_cast<JSObjectRef>(offsets));
+    return JSValue(static_cast<JSObjectRef>(result));
+}
+
 // =========================================================================
 // Scenery API - Object Loading
 // =========================================================================
@@ -9,9 +9,13 @@
 #include "XPLMInstance.h"
 #include "XPLMGraphics.h"
 #include "log_msg.h"
+#include "dataref_table.h"
 
+#include <cmath>
+#include <cstdint>
 #include <unordered_map>
 #include <string>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -31,6 +35,41 @@ public:
      */
     static void BindToView(RefPtr<View> view);
 
+    // Entries in the handle caches shared by all apps
+    struct CacheStats {
+        size_t datarefs = 0;
+        size_t handles = 0;
+        size_t objects = 0;
+        size_t instances = 0;
+        size_t probes = 0;
+    };
+    static CacheStats GetCacheStats();
+
+    /**
+     * @brief Destroy all instances and probes, unload all objects and forget cached datarefs
+     *
+     * Handles held by page scripts become invalid, call it when the pages are reloaded anyway
+     * (aircraft unload). Returns what was released.
+     */
+    static CacheStats ReleaseAll();
+
+    /**
+     * @brief Sample a view's dataref subscriptions and hand what changed to its page
+     *
+     * Called once per flight loop for every view. Reading and change detection are
+     * native, the page is only called (once, with all changed values) when at least
+     * one subscription moved by more than its epsilon. Returns true if it was called.
+     */
+    static bool DispatchSubscriptions(View* view, double now);
+
+    // Sample the snapshot datarefs and refresh every page's buffers, once per flight loop
+    // before any page runs
+    static void SampleSnapshot();
+
+    // The view's page is going away (reload, suspend, shutdown), drop its subscriptions
+    // and snapshot slots
+    static void UnbindView(View* view);
+
 private:
     // DataRef handle cache - maps dataref name to handle
     static std::unordered_map<std::string, XPLMDataRef> dataref_cache_;
@@ -39,6 +78,82 @@ private:
     // Helper to get or cache a dataref
     static XPLMDataRef GetCachedDataRef(const std::string& name);
 
+    // Handles returned by find(), shared by all apps
+    static DataRefTable handles_;
+
+    // Handle for a dataref name, 0 if the dataref doesn't exist. With pending, a handle is
+    // made for a dataref that doesn't exist yet, HandleDataRef() resolves it once it does.
+    static int GetDataRefHandle(const std::string& name, bool pending = false);
+    static XPLMDataRef HandleDataRef(int handle);
+
+    // First argument of a getter/setter: a handle (fast path) or a name, logs if it doesn't resolve
+    static XPLMDataRef ResolveDataRef(const JSArgs& args, const char* function);
+    static std::string DataRefName(const JSValue& arg);  // for error messages
+
+    // Element storage of a typed array of the given type, nullptr for anything else.
+    // The pointer is only valid until the next JavaScriptCore call.
+    static void* TypedArrayData(JSContextRef ctx, JSValueRef value, JSTypedArrayType type, size_t& length);
+    static JSObjectRef MakeTypedArray(JSContextRef ctx, JSTypedArrayType type, size_t length, void*& data);
+
+    // Dataref sets for readMany(), id = index + 1. Entries keep the ref and type they
+    // were last read with, so a read is one XPLMGetData call per entry.
+    struct DataRefSetEntry {
+        int handle = 0;
+        int index = -1;  // element of an array dataref, -1 for scalars
+        XPLMDataRef ref = nullptr;
+        XPLMDataTypeID type = xplmType_Unknown;
+        bool warned = false;  // logged a failed read
+    };
+    static std::vector<std::vector<DataRefSetEntry>> sets_;
+
+    // Widest scalar type, or float/int array type for elements
+    static XPLMDataTypeID PickReadType(XPLMDataRef ref, bool element);
+    // subscribe() state per view, the callbacks themselves live in the page (kSubscribeShim)
+    struct Subscription {
+        int id = 0;
+        DataRefSetEntry entry;
+        double period = 0.0;       // seconds between samples, 0 = every flight loop
+        double epsilon = 0.0;      // changes up to this size are not delivered
+        double next_sample = 0.0;
+        double value = NAN;        // last value handed to the page, or waiting to be
+        bool pending = false;
+    };
+    static std::unordered_map<View*, std::vector<Subscription>> subscriptions_;
+    static int next_subscription_id_;
+    static const char* const kSubscribeShim;
+
+    // snapshot(): every distinct dataref any page declared gets one slot, sampled once per
+    // frame. Each snapshot() call gets its own buffer (frame counter, then its schema in
+    // order), refreshed from the slots, so a page writing into it only affects itself.
+    static constexpr size_t kMaxSnapshotSlots = 4096;
+    struct SnapshotSlot {
+        DataRefSetEntry entry;
+        double value = NAN;
+        int refs = 0;  // views holding it, each counted once
+    };
+    struct SnapshotBuffer {
+        std::shared_ptr<std::vector<double>> data;  // also owned by the page's ArrayBuffer
+        std::vector<int> slots;
+    };
+    struct SnapshotView {
+        std::vector<int> slots;  // held by this view
+        std::vector<SnapshotBuffer> buffers;
+    };
+    static std::vector<SnapshotSlot> snapshot_slots_;
+    static std::unordered_map<View*, SnapshotView> snapshot_views_;
+    static uint64_t snapshot_frame_;
+
+    // Slot for an entry, shared with other views when one exists, -1 when all slots are used.
+    // added is set when the view didn't hold the slot before.
+    static int AcquireSnapshotSlot(View* view, const DataRefSetEntry& entry, bool& added);
+    static void ReleaseSnapshotSlots(View* view, const std::vector<int>& slots);
+
+    // Path, "path[index]" or handle to an entry. Paths that don't resolve yet get a pending
+    // handle, handle 0 means an invalid argument.
+    static DataRefSetEntry ParseSetEntry(const JSValue& item);
+    // Current value as a double, NaN (logged once) while the dataref doesn't resolve
+    static double ReadSetEntry(DataRefSetEntry& entry);
+
     // =========================================================================
     // DataRef Lookup Functions
     // =========================================================================
@@ -52,14 +167,14 @@ private:
 
     /**
      * @brief Check if a dataref is writable
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @return true if writable, false otherwise
      */
     static JSValue JS_CanWriteDataRef(const JSObject& thisObject, const JSArgs& args);
 
     /**
      * @brief Get the type(s) of a dataref
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @return Object with boolean flags for each type
      */
     static JSValue JS_GetDataRefTypes(const JSObject& thisObject, const JSArgs& args);
@@ -70,28 +185,28 @@ private:
 
     /**
      * @brief Get an integer dataref value
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @return Integer value
      */
     static JSValue JS_GetDatai(const JSObject& thisObject, const JSArgs& args);
 
     /**
      * @brief Get a float dataref value
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @return Float value
      */
     static JSValue JS_GetDataf(const JSObject& thisObject, const JSArgs& args);
 
     /**
      * @brief Get a double dataref value
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @return Double value
      */
     static JSValue JS_GetDatad(const JSObject& thisObject, const JSArgs& args);
 
     /**
      * @brief Get an integer array dataref
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @param offset (optional) Start offset in array, default 0
      * @param count (optional) Number of elements to read, default all
      * @return Array of integers
@@ -100,7 +215,7 @@ private:
 
     /**
      * @brief Get a float array dataref
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @param offset (optional) Start offset in array, default 0
      * @param count (optional) Number of elements to read, default all
      * @return Array of floats
@@ -109,7 +224,7 @@ private:
 
     /**
      * @brief Get a byte array (data) dataref as string
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @param offset (optional) Start offset, default 0
      * @param maxBytes (optional) Maximum bytes to read, default all
      * @return String value
@@ -122,28 +237,28 @@ private:
 
     /**
      * @brief Set an integer dataref value
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @param value The value to set
      */
     static JSValue JS_SetDatai(const JSObject& thisObject, const JSArgs& args);
 
     /**
      * @brief Set a float dataref value
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @param value The value to set
      */
     static JSValue JS_SetDataf(const JSObject& thisObject, const JSArgs& args);
 
     /**
      * @brief Set a double dataref value
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @param value The value to set
      */
     static JSValue JS_SetDatad(const JSObject& thisObject, const JSArgs& args);
 
     /**
      * @brief Set an integer array dataref
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @param values Array of integers to write
      * @param offset (optional) Start offset in array, default 0
      */
@@ -151,7 +266,7 @@ private:
 
     /**
      * @brief Set a float array dataref
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @param values Array of floats to write
      * @param offset (optional) Start offset in array, default 0
      */
@@ -159,12 +274,49 @@ private:
 
     /**
      * @brief Set a byte array (data) dataref from string
-     * @param name The dataref path
+     * @param dataref The dataref path, or a handle from find()
      * @param value String value to write
      * @param offset (optional) Start offset, default 0
      */
     static JSValue JS_SetDatab(const JSObject& thisObject, const JSArgs& args);
 
+    // =========================================================================
+    // Bulk Reads
+    // =========================================================================
+
+    /**
+     * @brief Register a list of datarefs for readMany()
+     * @param datarefs Array of handles or paths, "path[i]" for one element of an array dataref
+     * @return Set ID (number), the same ID for a list that was defined before
+     */
+    static JSValue JS_DefineSet(const JSObject& thisObject, const JSArgs& args);
+
+    /**
+     * @brief Read every dataref of a set into a Float64Array in one call
+     * @param setId ID from defineSet()
+     * @param out Float64Array, element i receives dataref i (NaN if it doesn't resolve)
+     * @return Number of elements written
+     */
+    static JSValue JS_ReadMany(const JSObject& thisObject, const JSArgs& args);
+
+    /**
+     * @brief Subscribe to a dataref, native half of XPlane.dataref.subscribe
+     * @param dataref Handle, path or "path[index]"
+     * @param hz Samples per second (0 = every flight loop)
+     * @param epsilon Smallest change that is delivered
+     * @return Subscription ID (number), 0 for an invalid handle
+     */
+    static JSValue Subscribe(View* view, const JSArgs& args);
+    static JSValue Unsubscribe(View* view, const JSArgs& args);
+
+    /**
+     * @brief Declare named datarefs to read from a buffer refreshed once per frame
+     * @param schema Object of name -> handle, path or "path[index]"
+     * @return {buffer, values, offsets}: the ArrayBuffer, a Float64Array over it (values[0] is
+     *         the frame counter) and the index of every name in values. null if all slots are used.
+     */
+    static JSValue Snapshot(View* view, const JSObject& thisObject, const JSArgs& args);
+
     // =========================================================================
     // Scenery API - Object Loading
     // =========================================================================
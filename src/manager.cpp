@@ -1,5 +1,28 @@
 #include "manager.h"
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+// Menu item ref for the debug force repaint toggle, compared by address in menuCB
+static const char kForceRepaintItem[] = "Debug: Force Repaint";
+static const char kAdaptiveThrottleItem[] = "Adaptive Render Throttling";
+static const char kReloadAppsItem[] = "Reload Apps";
+
+// Adaptive throttling never slows apps below this fraction of their rate
+static const double kMinRateScale = 0.1;
+// Seconds between adaptive rate adjustments, long enough to see the effect of the last one
+static const double kRateScaleInterval = 0.25;
+
+// Sim frame time the adaptive throttle and preloading aim for, unless the prefs say otherwise
+static const double kDefaultFrameBudget = 1.0 / 30.0;
+// Share of the frame budget Renderer::Update() may take, 5 ms at 30 fps
+static const double kUpdateBudgetShare = 0.15;
+
+// Preloaded apps start this long after the aircraft loaded, then one per kWarmUpInterval
+static const double kWarmUpDelay = 2.0;
+static const double kWarmUpInterval = 0.5;
+
 Manager &Manager::instance()
 {
     static Manager instance;
@@ -12,6 +35,7 @@ Manager::Manager()
     strcpy(name, (app_name + " - " VERSION_SHORT " - ").c_str());
     strcpy(signature, "com.github.x-z7a.skyscript");
     strcpy(description, "Powerfull JavaScript runtime for X-Plane plugins");
+    setFrameBudget(kDefaultFrameBudget);
 
     // renderer_ = Renderer::Create();
 }
@@ -23,17 +47,46 @@ Manager::~Manager()
 
 float update(float inElapsedSinceLastCall, float inElapsedTimeSinceLastFlightLoop, int inCounter, void *inRefcon)
 {
-    Manager::instance().renderer_->Update();
+    // Nothing loaded or waiting to load: stop drawing and go dormant until an app is opened
+    if (!Manager::instance().hasLiveApps())
+    {
+        Manager::instance().pauseCallbacks();
+        return 0.0f;
+    }
+
+    // Sample dataref snapshots and subscriptions first so pages see this frame's values,
+    // then run JS timers, layout and network callbacks within the per-frame budget
+    double start = App::Now();
+    JSBindings::SampleSnapshot();
+    Manager::instance().dispatchSubscriptions();
+    Manager::instance().getUpdateScheduler().Tick(Manager::instance().renderer_.get());
+    Manager::instance().notePhase(Manager::kPhaseUpdate, App::Now() - start);
+    Manager::instance().warmUpApps();
     return -1.0f; // call me every frame for smooth rendering
 }
 
 // Draw callback - called during X-Plane's 2D drawing phase
 int drawCallback(XPLMDrawingPhase inPhase, int inIsBefore, void *inRefcon)
 {
-    Manager::instance().forceRepaintAllApps(); // Mark all visible views as needing paint
-    Manager::instance().renderer_->Render();   // Render views to bitmaps
-    Manager::instance().updateAllApps();       // Upload bitmaps to textures
-    Manager::instance().drawAllApps();         // Draw textured quads
+    Manager &manager = Manager::instance();
+    double start = App::Now();
+    manager.renderer_->RefreshDisplay(0);      // Tick animations and requestAnimationFrame
+    if (manager.scheduleRepaints())            // Only paint when a visible view is dirty
+        manager.renderScheduledViews();        // Render those views, hidden apps stay frozen
+    GPUDriverGL::instance().DrawCommandList(); // Rasterize accelerated views into their FBOs
+    double rendered = App::Now();
+    manager.updateAllApps();                   // Upload bitmaps to textures, the windows draw them next frame
+    double uploaded = App::Now();
+    manager.updateMemory();                    // Release hidden apps' textures, purge when over budget
+    manager.checkWatchdog();                   // Attribute the frame to apps, throttle the expensive ones
+
+    // The app windows were drawn by X-Plane just before this callback
+    double drawn = manager.takeDrawTime();
+    manager.notePhase(Manager::kPhaseRender, rendered - start);
+    manager.notePhase(Manager::kPhaseUpload, uploaded - rendered);
+    manager.notePhase(Manager::kPhaseDraw, drawn);
+    manager.notePhase(Manager::kPhaseFrame, manager.getPhaseTimer(Manager::kPhaseUpdate).stats().last_ms / 1000.0 +
+                                                drawn + App::Now() - start);
     return 1;
 }
 
@@ -49,18 +102,19 @@ PLUGIN_API void XPluginReceiveMessage(XPLMPluginID from, long msg, void *params)
         }
 
         LogMsg("Plane loaded message received.");
-        Manager::instance().initializeAllApps();
+        Manager::instance().onPlaneLoaded();
         break;
 
-        // case XPLM_MSG_PLANE_UNLOADED:
-        //     if ((intptr_t)params != 0) {
-        //         // It was not the user's plane. Ignore.
-        //         return;
-        //     }
+    case XPLM_MSG_PLANE_UNLOADED:
+        if ((intptr_t)params != 0)
+        {
+            // It was not the user's plane. Ignore.
+            return;
+        }
 
-        //     Dataref::getInstance()->executeCommand("AviTab/Home");
-        //     AppState::getInstance()->deinitialize();
-        //     break;
+        LogMsg("Plane unloaded message received.");
+        Manager::instance().onPlaneUnloaded();
+        break;
 
     default:
         break;
@@ -70,6 +124,7 @@ PLUGIN_API void XPluginReceiveMessage(XPLMPluginID from, long msg, void *params)
 int Manager::initialize(char *out_name, char *out_sig, char *out_desc)
 {
     LogMsg("Startup " VERSION);
+    double start = App::Now();
 
     // Initialization code here
     strcpy(out_name, name);
@@ -96,23 +151,20 @@ int Manager::initialize(char *out_name, char *out_sig, char *out_desc)
     // Discover apps and create menu items
     discoverApps();
 
-    LogMsg("XPluginStart done, xp_dir: '%s'", Manager::instance().getXpDir().c_str());
+    XPLMAppendMenuSeparator(menu_);
+    adaptive_throttle_item_ = XPLMAppendMenuItem(menu_, kAdaptiveThrottleItem, (void *)kAdaptiveThrottleItem, 0);
+    XPLMCheckMenuItem(menu_, adaptive_throttle_item_, xplm_Menu_Unchecked);
+    XPLMAppendMenuItem(menu_, kReloadAppsItem, (void *)kReloadAppsItem, 0);
+    force_repaint_item_ = XPLMAppendMenuItem(menu_, kForceRepaintItem, (void *)kForceRepaintItem, 0);
+    XPLMCheckMenuItem(menu_, force_repaint_item_, xplm_Menu_Unchecked);
 
-    // intialize Ultralight here
-    Config config;
-    config.user_stylesheet = "body { background-color: #202020; color: #E0E0E0; }";
-    Platform::instance().set_config(config);
-    Platform::instance().set_font_loader(GetPlatformFontLoader());
-    Platform::instance().set_file_system(GetPlatformFileSystem(plugin_dir.c_str()));
-    Platform::instance().set_logger(GetDefaultLogger("ultralight.log"));
+    frame_period_ref_ = XPLMFindDataRef("sim/operation/misc/frame_rate_period");
+    loadPrefs();
+    registerPerfDataRefs();
 
-    renderer_ = Renderer::Create();
-
-    // register XP draw callbacks to call renderer_->Update() and renderer_->Render()
-    XPLMRegisterFlightLoopCallback(update, 0.1, nullptr);
-    
-    // Register draw callback to draw all app windows during 2D phase
-    XPLMRegisterDrawCallback(drawCallback, xplm_Phase_Window, 0, nullptr);
+    // Ultralight, the renderer and the sim callbacks wait for the first app that is opened or preloaded
+    startup_ms_ = (App::Now() - start) * 1000.0;
+    LogMsg("XPluginStart done in %.1f ms, xp_dir: '%s'", startup_ms_, Manager::instance().getXpDir().c_str());
 
     // RefPtr<View> view = renderer_->CreateView(800, 600, ViewConfig(), nullptr);
 
@@ -149,13 +201,255 @@ int Manager::initialize(char *out_name, char *out_sig, char *out_desc)
     return 1;
 }
 
+bool Manager::ensureRenderer()
+{
+    if (renderer_)
+        return true;
+
+    double start = App::Now();
+
+    // intialize Ultralight here
+    Config config;
+    config.user_stylesheet = "body { background-color: #202020; color: #E0E0E0; }";
+    config.max_update_time = update_scheduler_.timer_budget();
+    Platform::instance().set_config(config);
+    Platform::instance().set_font_loader(GetPlatformFontLoader());
+    Platform::instance().set_file_system(GetPlatformFileSystem(plugin_dir.c_str()));
+    Platform::instance().set_logger(GetDefaultLogger("ultralight.log"));
+
+    // Views paint straight into texture upload buffers
+    UploadSurfaceFactory::instance().Install();
+
+    // Apps can opt into GPU rendering when the context has GL 3.2
+    GPUDriverGL::instance().Install();
+
+    renderer_ = Renderer::Create();
+
+    renderer_create_ms_ = (App::Now() - start) * 1000.0;
+    LogMsg("Renderer created in %.1f ms", renderer_create_ms_);
+    return renderer_.get() != nullptr;
+}
+
+void Manager::registerPerfDataRefs()
+{
+    static const char *const phases[kPhaseCount] = {"update", "render", "upload", "draw", "frame"};
+    static const char *const stats[] = {"last_ms", "min_ms", "avg_ms", "p99_ms"};
+
+    // Read-only floats, refcon = phase * 4 + statistic
+    auto read = [](void *refcon) -> float
+    {
+        intptr_t id = reinterpret_cast<intptr_t>(refcon);
+        const PhaseTimer::Stats &s = Manager::instance().getPhaseTimer(static_cast<Phase>(id / 4)).stats();
+        double values[] = {s.last_ms, s.min_ms, s.avg_ms, s.p99_ms};
+        return static_cast<float>(values[id % 4]);
+    };
+
+    for (int phase = 0; phase < kPhaseCount; phase++)
+    {
+        for (int stat = 0; stat < 4; stat++)
+        {
+            std::string dataref = std::string("skyscript/perf/") + phases[phase] + "/" + stats[stat];
+            XPLMRegisterDataAccessor(dataref.c_str(), xplmType_Float, 0,
+                                     nullptr, nullptr, read, nullptr, nullptr, nullptr,
+                                     nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                     reinterpret_cast<void *>(static_cast<intptr_t>(phase * 4 + stat)), nullptr);
+        }
+    }
+
+    // Single values, refcon = the entry
+    struct Value
+    {
+        const char *name;
+        float (*read)();
+    };
+    static const Value values[] = {
+        {"skyscript/perf/startup_ms", [] { return static_cast<float>(Manager::instance().getStartupMs()); }},
+        {"skyscript/perf/renderer_create_ms", [] { return static_cast<float>(Manager::instance().getRendererCreateMs()); }},
+        {"skyscript/perf/render_rate_scale", [] { return static_cast<float>(Manager::instance().getRenderRateScale()); }},
+        {"skyscript/memory/total_mb", [] { return static_cast<float>(Manager::instance().getMemoryManager().totals().bytes() / 1048576.0); }},
+        {"skyscript/memory/bitmap_mb", [] { return static_cast<float>(Manager::instance().getMemoryManager().totals().bitmap_bytes / 1048576.0); }},
+        {"skyscript/memory/texture_mb", [] { return static_cast<float>(Manager::instance().getMemoryManager().totals().texture_bytes / 1048576.0); }},
+        {"skyscript/memory/pool_mb", [] { return static_cast<float>(Manager::instance().getMemoryManager().totals().pool_bytes / 1048576.0); }},
+        {"skyscript/memory/budget_mb", [] { return static_cast<float>(Manager::instance().getMemoryManager().budget() / 1048576.0); }},
+    };
+    for (const Value &value : values)
+    {
+        XPLMRegisterDataAccessor(value.name, xplmType_Float, 0,
+                                 nullptr, nullptr,
+                                 [](void *refcon) -> float { return static_cast<const Value *>(refcon)->read(); },
+                                 nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                 const_cast<Value *>(&value), nullptr);
+    }
+
+    // Integers: counts of the last frame and counters since startup
+    struct Counter
+    {
+        const char *name;
+        int (*read)();
+    };
+    static const Counter counters[] = {
+        {"skyscript/perf/render/views", [] { return static_cast<int>(Manager::instance().getFrameRenderedViews()); }},
+        {"skyscript/perf/upload/bytes", [] { return static_cast<int>(Manager::instance().getFrameUploadBytes()); }},
+        {"skyscript/perf/update/deferred", [] { return static_cast<int>(Manager::instance().getUpdateScheduler().stats().deferred); }},
+        {"skyscript/perf/update/over_budget", [] { return static_cast<int>(Manager::instance().getUpdateScheduler().stats().over_budget); }},
+        {"skyscript/memory/purges", [] { return static_cast<int>(Manager::instance().getMemoryManager().totals().purges); }},
+    };
+    for (const Counter &counter : counters)
+    {
+        XPLMRegisterDataAccessor(counter.name, xplmType_Int, 0,
+                                 [](void *refcon) -> int { return static_cast<const Counter *>(refcon)->read(); },
+                                 nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                 nullptr, nullptr, const_cast<Counter *>(&counter), nullptr);
+    }
+}
+
+void Manager::loadPrefs()
+{
+    // Optional, every setting has a default
+    std::ifstream file(pref_path);
+    if (!file)
+        return;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        std::string key;
+        double value = 0.0;
+        if (!(fields >> key) || key[0] == '#')
+            continue;
+        if (!(fields >> value) || value < 0.0)
+        {
+            LogMsg("Preferences: ignoring '%s'", line.c_str());
+            continue;
+        }
+
+        if (key == "frame_budget_ms" && value > 0.0)
+            setFrameBudget(value / 1000.0);
+        else if (key == "memory_budget_mb")
+            setMemoryBudget(static_cast<size_t>(value * 1048576.0));
+        else if (key == "suspend_after_s")
+            setSuspendAfter(value);
+        else if (key == "upload_pbo")
+            TextureUploader::set_pixel_buffer_mode(value > 0.0 ? TextureUploader::kPixelBuffersOn
+                                                               : TextureUploader::kPixelBuffersOff);
+        else
+        {
+            LogMsg("Preferences: ignoring '%s'", line.c_str());
+            continue;
+        }
+        LogMsg("Preferences: %s %g", key.c_str(), value);
+    }
+}
+
+bool Manager::hasLiveApps() const
+{
+    if (!warmup_queue_.empty())
+        return true;
+    for (const auto &[name, app] : apps_)
+    {
+        if (app && app->IsInitialized() && !app->IsSuspended())
+            return true;
+    }
+    return false;
+}
+
+void Manager::resumeCallbacks()
+{
+    if (callbacks_active_ || !renderer_)
+        return;
+
+    // Update() runs JS timers, layout and network callbacks every frame
+    if (!flight_loop_registered_)
+    {
+        XPLMRegisterFlightLoopCallback(update, -1.0f, nullptr);
+        flight_loop_registered_ = true;
+    }
+    else
+    {
+        XPLMSetFlightLoopCallbackInterval(update, -1.0f, 1, nullptr);
+    }
+
+    // Register draw callback to draw all app windows during 2D phase
+    XPLMRegisterDrawCallback(drawCallback, xplm_Phase_Window, 0, nullptr);
+    callbacks_active_ = true;
+    LogMsg("Sim callbacks registered");
+}
+
+void Manager::pauseCallbacks()
+{
+    if (!callbacks_active_)
+        return;
+
+    // The flight loop deactivates itself by returning 0
+    XPLMUnregisterDrawCallback(drawCallback, xplm_Phase_Window, 0, nullptr);
+    callbacks_active_ = false;
+
+    // Dormant, SkyScript costs nothing per frame
+    for (PhaseTimer &timer : phase_timers_)
+        timer.Reset();
+    LogMsg("No live apps, sim callbacks paused");
+}
+
 void Manager::enable()
 {
-    LogMsg("Plugin enabled");
+    if (!disabled_)
+    {
+        LogMsg("Plugin enabled");
+        return;
+    }
+    disabled_ = false;
+
+    // Only the windows that were open come back right away, the others when they are shown
+    double start = App::Now();
+    for (const std::string &name : reopen_apps_)
+    {
+        auto it = apps_.find(name);
+        if (it != apps_.end() && it->second)
+            initializeApp(*it->second);
+    }
+    LogMsg("Plugin enabled, %zu app(s) reopened in %.1f ms", reopen_apps_.size(), (App::Now() - start) * 1000.0);
+    reopen_apps_.clear();
+    queuePreloadApps();
 }
+
 void Manager::disable()
 {
-    LogMsg("Plugin disabled");
+    // Leave nothing behind but the menu and the renderer: windows, views, textures,
+    // callbacks and scenery handles go, with a snapshot of each window to come back to
+    double start = App::Now();
+    int closed = 0;
+    reopen_apps_.clear();
+    for (auto &[name, app] : apps_)
+    {
+        if (!app || !app->IsInitialized())
+            continue;
+        if (app->Shutdown())
+            reopen_apps_.push_back(name);
+        watchdog_.Forget(name);
+        closed++;
+    }
+    warmup_queue_.clear();
+
+    pauseCallbacks();
+    if (flight_loop_registered_)
+    {
+        XPLMUnregisterFlightLoopCallback(update, nullptr);
+        flight_loop_registered_ = false;
+    }
+
+    // Let the renderer destroy what the dropped views held before purging its caches
+    if (renderer_)
+    {
+        renderer_->Update();
+        renderer_->Render();
+        renderer_->PurgeMemory();
+    }
+    TexturePool::instance().Trim();
+    JSBindings::ReleaseAll();
+
+    disabled_ = true;
+    LogMsg("Plugin disabled, %d app(s) closed in %.1f ms", closed, (App::Now() - start) * 1000.0);
 }
 
 void Manager::menuCB(void *menu_ref, void *item_ref)
@@ -167,12 +461,33 @@ void Manager::menuCB(void *menu_ref, void *item_ref)
         return;
     }
 
+    if (item_name == kForceRepaintItem)
+    {
+        Manager::instance().setForceRepaint(!Manager::instance().getForceRepaint());
+        return;
+    }
+
+    if (item_name == kReloadAppsItem)
+    {
+        Manager::instance().reloadApps(false);
+        return;
+    }
+
+    if (item_name == kAdaptiveThrottleItem)
+    {
+        Manager::instance().setAdaptiveThrottle(!Manager::instance().getAdaptiveThrottle());
+        return;
+    }
+
     // Find the app and toggle its window
     auto &apps = Manager::instance().apps_;
     auto it = apps.find(item_name);
     if (it != apps.end() && it->second)
     {
+        // Apps are created on first use, Initialize() leaves the window hidden
+        Manager::instance().initializeApp(*it->second);
         it->second->Toggle();
+        Manager::instance().resumeCallbacks();  // showing a suspended app makes it live again
         LogMsg("Toggled app: %s, visible: %d", item_name, it->second->IsVisible());
     }
     else
@@ -212,41 +527,185 @@ void Manager::discoverApps()
     }
 }
 
-void Manager::initializeAllApps()
+bool Manager::initializeApp(App &app)
+{
+    if (app.IsInitialized() || !ensureRenderer())
+        return false;
+
+    double start = App::Now();
+    app.Initialize(renderer_);
+    LogMsg("Initialized app %s in %.1f ms", app.GetName().c_str(), (App::Now() - start) * 1000.0);
+
+    warmup_queue_.erase(std::remove(warmup_queue_.begin(), warmup_queue_.end(), app.GetName()), warmup_queue_.end());
+    resumeCallbacks();
+    return true;
+}
+
+void Manager::queuePreloadApps()
+{
+    // Apps are initialized on first show, only "preload" apps are warmed up ahead of time
+    for (auto &[name, app] : apps_)
+    {
+        if (app && !app->IsInitialized() && app->WantsPreload() &&
+            std::find(warmup_queue_.begin(), warmup_queue_.end(), name) == warmup_queue_.end())
+        {
+            warmup_queue_.push_back(name);
+        }
+    }
+    if (!warmup_queue_.empty() && ensureRenderer())
+    {
+        LogMsg("Preloading %zu app(s) in the background", warmup_queue_.size());
+        next_warmup_ = App::Now() + kWarmUpDelay;
+        resumeCallbacks();
+    }
+}
+
+void Manager::onPlaneLoaded()
+{
+    // Apps keep their view and window across aircraft, only the pages start over
+    if (plane_unloaded_)
+        reloadApps(true);
+    plane_unloaded_ = false;
+    queuePreloadApps();
+}
+
+void Manager::onPlaneUnloaded()
+{
+    // Objects, instances and probes belong to the old flight, the pages reload with the next aircraft
+    JSBindings::ReleaseAll();
+    warmup_queue_.clear();
+    plane_unloaded_ = true;
+}
+
+void Manager::reloadApps(bool aircraft_changed)
 {
-    // Initialize all discovered apps (renderer is now ready)
+    // Handles are shared by all pages and every page starts over, the old ones would leak
+    double start = App::Now();
+    if (!plane_unloaded_)
+        JSBindings::ReleaseAll();
+
+    int reloaded = 0;
     for (auto &[name, app] : apps_)
     {
-        if (app)
+        if (app && app->IsInitialized())
         {
-            LogMsg("Initializing app: %s", name.c_str());
-            app->Initialize(renderer_);
+            app->Reload(aircraft_changed);
+            reloaded++;
         }
     }
+    if (reloaded > 0)
+        LogMsg("Reloaded %d app(s) in %.1f ms", reloaded, (App::Now() - start) * 1000.0);
+}
+
+void Manager::warmUpApps()
+{
+    if (warmup_queue_.empty())
+        return;
+
+    // One app at a time, and only while the sim has frame time to spare
+    double now = App::Now();
+    if (now < next_warmup_ || frame_time_avg_ > frame_budget_)
+        return;
+    next_warmup_ = now + kWarmUpInterval;
+
+    std::string name = warmup_queue_.front();
+    warmup_queue_.erase(warmup_queue_.begin());
+    auto it = apps_.find(name);
+    if (it != apps_.end() && it->second)
+        initializeApp(*it->second);
+}
+
+void Manager::dispatchSubscriptions()
+{
+    // Sampled here so pages see the new values before their timers run, the
+    // callbacks count against the app's script time like any other callback
+    double now = App::Now();
+    for (auto &[name, app] : apps_)
+    {
+        if (!app || !app->GetView())
+            continue;
+        double start = App::Now();
+        if (JSBindings::DispatchSubscriptions(app->GetView(), now))
+            watchdog_.Note(name, Watchdog::kScript, App::Now() - start);
+    }
 }
 
 void Manager::updateAllApps()
 {
     // Update textures for all visible apps
+    frame_upload_bytes_ = 0;
     for (auto &[name, app] : apps_)
     {
         if (app && app->IsVisible())
         {
-            app->UpdateTexture();
+            app->CheckResize();
+            double start = App::Now();
+            frame_upload_bytes_ += app->UpdateTexture();
+            watchdog_.Note(name, Watchdog::kUpload, App::Now() - start);
         }
     }
 }
 
-void Manager::drawAllApps()
+void Manager::drawApp(App &app)
+{
+    // X-Plane calls the window draw callbacks in its own window order, popped-out and
+    // VR windows included, so each window draws itself with one bind and one quad
+    double start = App::Now();
+    app.Draw();
+    frame_draw_time_ += App::Now() - start;
+}
+
+double Manager::takeDrawTime()
+{
+    double seconds = frame_draw_time_;
+    frame_draw_time_ = 0.0;
+    return seconds;
+}
+
+void Manager::checkWatchdog()
+{
+    // Timer and animation frame callbacks ran in Update() and RefreshDisplay(), hidden apps included
+    for (auto &[name, app] : apps_)
+    {
+        if (app && app->IsInitialized())
+            watchdog_.Note(name, Watchdog::kScript, app->TakeScriptTime());
+    }
+
+    watchdog_.EndFrame(App::Now(), watchdog_changes_);
+    for (const std::string &name : watchdog_changes_)
+    {
+        auto it = apps_.find(name);
+        if (it != apps_.end() && it->second)
+            it->second->SetThrottle(watchdog_.Throttle(name));
+    }
+}
+
+void Manager::updateMemory()
 {
-    // Draw all visible apps
+    double now = App::Now();
+    if (!memory_manager_.Due(now))
+        return;
+
+    std::vector<MemoryManager::AppUsage> usage;
+    usage.reserve(apps_.size());
     for (auto &[name, app] : apps_)
     {
-        if (app && app->IsVisible())
+        if (!app)
+            continue;
+
+        // Hidden apps give their upload texture back to the pool, long-hidden ones drop the view too
+        bool visible = app->IsVisible();
+        if (!visible && app->ReleaseGraphics())
         {
-            app->Draw();
+            memory_manager_.NoteHidden(now);
         }
+        if (!visible && app->ShouldSuspend(now, suspend_after_) && app->Suspend())
+        {
+            memory_manager_.NoteHidden(now);
+        }
+        usage.push_back({name, visible, app->GetBitmapBytes(), app->GetTextureBytes()});
     }
+    memory_manager_.Tick(std::move(usage), renderer_.get(), now);
 }
 
 void Manager::forceRepaintAllApps()
@@ -259,4 +718,97 @@ void Manager::forceRepaintAllApps()
             app->ForceRepaint();
         }
     }
-}
\ No newline at end of file
+}
+
+bool Manager::scheduleRepaints()
+{
+    // Debug mode: defeat dirty tracking and repaint everything visible
+    if (force_repaint_)
+    {
+        forceRepaintAllApps();
+    }
+
+    updatePacing();
+
+    // Views only repaint when Ultralight reports them dirty, or when they
+    // were resized, shown or received input since the last frame, and only
+    // as often as their frame-rate cap and the adaptive throttle allow
+    render_apps_.clear();
+    frame_rendered_views_ = 0;
+    for (auto &[name, app] : apps_)
+    {
+        if (app && app->IsVisible() && app->SchedulePaint(pacing_))
+            render_apps_.push_back(app.get());
+    }
+    return !render_apps_.empty();
+}
+
+void Manager::renderScheduledViews()
+{
+    // Render() would also paint every hidden app's view. One view per call so the
+    // watchdog and auto render scale get each app's own raster time.
+    frame_rendered_views_ = render_apps_.size();
+    for (App *app : render_apps_)
+    {
+        View *view = app->GetView();
+        double start = App::Now();
+        renderer_->RenderOnly(&view, 1);
+        double elapsed = App::Now() - start;
+        watchdog_.Note(app->GetName(), Watchdog::kPaint, elapsed);
+        if (app->IsAutoRenderScale())
+            app->NoteRasterTime(elapsed, pacing_.now);
+    }
+}
+
+void Manager::setForceRepaint(bool v)
+{
+    force_repaint_ = v;
+    XPLMCheckMenuItem(menu_, force_repaint_item_, v ? xplm_Menu_Checked : xplm_Menu_Unchecked);
+    LogMsg("Force repaint %s", v ? "enabled" : "disabled");
+}
+
+void Manager::updatePacing()
+{
+    double now = App::Now();
+    double period = frame_period_ref_ ? XPLMGetDataf(frame_period_ref_) : 0.0;
+    if (period <= 0.0 && last_pacing_time_ >= 0.0)
+        period = now - last_pacing_time_;
+    last_pacing_time_ = now;
+
+    pacing_.now = now;
+    pacing_.frame_period = period;
+
+    // Smooth out single-frame spikes (loading scenery, GC) before reacting
+    frame_time_avg_ = frame_time_avg_ > 0.0 ? frame_time_avg_ * 0.9 + period * 0.1 : period;
+
+    if (!adaptive_throttle_)
+    {
+        pacing_.rate_scale = 1.0;
+        return;
+    }
+    if (now - last_scale_change_ < kRateScaleInterval)
+        return;
+    last_scale_change_ = now;
+
+    // Back off quickly when over budget, recover slowly once there is headroom
+    double scale = pacing_.rate_scale;
+    if (frame_time_avg_ > frame_budget_ * 1.05)
+        scale = std::max(kMinRateScale, scale * 0.8);
+    else if (frame_time_avg_ < frame_budget_ * 0.9)
+        scale = std::min(1.0, scale * 1.1);
+    pacing_.rate_scale = scale;
+}
+
+void Manager::setFrameBudget(double seconds)
+{
+    frame_budget_ = seconds;
+    update_scheduler_.set_budget(seconds * kUpdateBudgetShare);
+}
+
+void Manager::setAdaptiveThrottle(bool v)
+{
+    adaptive_throttle_ = v;
+    pacing_.rate_scale = 1.0;
+    XPLMCheckMenuItem(menu_, adaptive_throttle_item_, v ? xplm_Menu_Checked : xplm_Menu_Unchecked);
+    LogMsg("Adaptive render throttling %s, budget %.1f ms", v ? "enabled" : "disabled", frame_budget_ * 1000.0);
+}
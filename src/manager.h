@@ -5,6 +5,7 @@
 #include <memory>
 #include <filesystem>
 #include <future>
+#include <vector>
 
 #include "XPLMDataAccess.h"
 #include "XPLMScenery.h"
@@ -22,6 +23,10 @@
 #include "log_msg.h"
 #include "../version.h"
 #include "app.h"
+#include "memory_manager.h"
+#include "phase_timer.h"
+#include "update_scheduler.h"
+#include "watchdog.h"
 using namespace ultralight;
 class Manager
 {
@@ -36,10 +41,48 @@ public:
     void disable();
     static void menuCB([[maybe_unused]] void *menu_ref, void *item_ref);
     void discoverApps();
-    void initializeAllApps();
+    void queuePreloadApps();
+    bool initializeApp(App &app);
+    void warmUpApps();
+
+    // Aircraft lifecycle: release scenery handles on unload, soft-reload initialized apps on the next load
+    void onPlaneLoaded();
+    void onPlaneUnloaded();
+    void reloadApps(bool aircraft_changed);
+
+    // Ultralight platform setup and Renderer::Create(), done when the first app needs it
+    bool ensureRenderer();
+
+    // The flight loop and draw callbacks only run while an app is initialized and not suspended
+    bool hasLiveApps() const;
+    void resumeCallbacks();
+    void pauseCallbacks();
+    void dispatchSubscriptions();  // XPlane.dataref.subscribe, from the flight loop
     void updateAllApps();
-    void drawAllApps();
+    void drawApp(App &app);  // from the app window's draw callback
+    double takeDrawTime();   // drawApp() time since the last call
     void forceRepaintAllApps();
+    bool scheduleRepaints();
+    void renderScheduledViews();
+    void updateMemory();
+    void checkWatchdog();
+
+    // Per-frame phases published as skyscript/perf/<phase>/{last,min,avg,p99}_ms
+    enum Phase
+    {
+        kPhaseUpdate,   // snapshot, subscriptions and Renderer::Update() in the flight loop
+        kPhaseRender,   // RefreshDisplay, RenderOnly and GPU rasterization
+        kPhaseUpload,   // updateAllApps()
+        kPhaseDraw,     // drawApp() for every window, X-Plane calls them before drawCallback
+        kPhaseFrame,    // all of the above for one sim frame
+        kPhaseCount
+    };
+    void notePhase(Phase phase, double seconds) { phase_timers_[phase].Add(seconds); }
+    const PhaseTimer &getPhaseTimer(Phase phase) const { return phase_timers_[phase]; }
+    void registerPerfDataRefs();
+
+    // Settings from the pref file ("key value" lines), read once at startup
+    void loadPrefs();
 
     // Plugin info getters
     const char *getName() const { return name; }
@@ -52,6 +95,38 @@ public:
     const std::string &getOutputDir() const { return output_dir; }
     const std::string &getPrefPath() const { return pref_path; }
 
+    // Startup cost: XPluginStart, and the deferred Ultralight setup (0 until an app is opened),
+    // skyscript/perf/startup_ms and skyscript/perf/renderer_create_ms
+    double getStartupMs() const { return startup_ms_; }
+    double getRendererCreateMs() const { return renderer_create_ms_; }
+
+    // Texture bytes uploaded by the last updateAllApps() call (skyscript/perf/upload/bytes)
+    size_t getFrameUploadBytes() const { return frame_upload_bytes_; }
+
+    // Views painted by the last renderScheduledViews() call (skyscript/perf/render/views)
+    size_t getFrameRenderedViews() const { return frame_rendered_views_; }
+
+    // Per-app memory, purges and the memory budget (pref memory_budget_mb, skyscript/memory/...)
+    const MemoryManager &getMemoryManager() const { return memory_manager_; }
+    void setMemoryBudget(size_t bytes) { memory_manager_.set_budget(bytes); }
+
+    // Seconds an app stays hidden before it may be suspended, 0 = never (pref suspend_after_s,
+    // apps can override it in their manifest)
+    void setSuspendAfter(double seconds) { suspend_after_ = seconds; }
+
+    // Renderer::Update() within a share of the frame budget, deferred frames and overruns
+    UpdateScheduler &getUpdateScheduler() { return update_scheduler_; }
+
+    // Adaptive throttling: lower app render rates while the sim frame time is over budget
+    bool getAdaptiveThrottle() const { return adaptive_throttle_; }
+    void setAdaptiveThrottle(bool v);
+    void setFrameBudget(double seconds);  // pref frame_budget_ms, also sets the Update() budget
+    double getRenderRateScale() const { return pacing_.rate_scale; }
+
+    // Debug: repaint every visible view every frame regardless of dirty state
+    bool getForceRepaint() const { return force_repaint_; }
+    void setForceRepaint(bool v);
+
     // Setters
     void setXpDir(const std::string &v) { xp_dir = v; }
     void setPluginDir(const std::string &v) { plugin_dir = v; }
@@ -69,6 +144,41 @@ private:
 
     std::unordered_map<std::string, std::unique_ptr<App>> apps_;
 
+    size_t frame_upload_bytes_ = 0;
+    size_t frame_rendered_views_ = 0;
+    std::vector<App *> render_apps_;  // visible and dirty, rebuilt by scheduleRepaints()
+    bool force_repaint_ = false;
+    int force_repaint_item_ = -1;
+
+    UpdateScheduler update_scheduler_;
+    double frame_draw_time_ = 0.0;  // drawApp() time since the last drawCallback
+    MemoryManager memory_manager_;
+    Watchdog watchdog_;
+    PhaseTimer phase_timers_[kPhaseCount];
+    std::vector<std::string> watchdog_changes_;
+    double suspend_after_ = 300.0;
+
+    double startup_ms_ = 0.0;
+    double renderer_create_ms_ = 0.0;
+    bool plane_unloaded_ = false;
+    bool disabled_ = false;
+    std::vector<std::string> reopen_apps_;  // visible when the plugin was disabled
+    bool flight_loop_registered_ = false;
+    bool callbacks_active_ = false;
+
+    std::vector<std::string> warmup_queue_;  // "preload" apps not initialized yet
+    double next_warmup_ = 0.0;
+
+    void updatePacing();
+    RenderPacing pacing_;
+    XPLMDataRef frame_period_ref_ = nullptr;
+    bool adaptive_throttle_ = false;
+    int adaptive_throttle_item_ = -1;
+    double frame_budget_ = 0.0;
+    double frame_time_avg_ = 0.0;
+    double last_pacing_time_ = -1.0;
+    double last_scale_change_ = 0.0;
+
 private:
     Manager();
     ~Manager();
@@ -0,0 +1,71 @@
+#include "memory_manager.h"
+
+#include "js_bindings.h"
+#include "log_msg.h"
+#include "texture_pool.h"
+
+void MemoryManager::NoteHidden(double now)
+{
+    hidden_purge_at_ = now + kHiddenPurgeDelay;
+}
+
+bool MemoryManager::Tick(std::vector<AppUsage> usage, Renderer *renderer, double now)
+{
+    last_sample_ = now;
+    apps_ = std::move(usage);
+
+    uint64_t purges = totals_.purges;
+    totals_ = Totals();
+    totals_.purges = purges;
+    for (const AppUsage &app : apps_)
+    {
+        totals_.bitmap_bytes += app.bitmap_bytes;
+        totals_.texture_bytes += app.texture_bytes;
+    }
+    totals_.pool_bytes = TexturePool::instance().free_bytes();
+
+    JSBindings::CacheStats caches = JSBindings::GetCacheStats();
+    totals_.datarefs = caches.datarefs;
+    totals_.objects = caches.objects;
+    totals_.instances = caches.instances;
+    totals_.probes = caches.probes;
+
+    if (!renderer)
+        return false;
+    if (last_purge_ >= 0.0 && now - last_purge_ < kPurgeCooldown)
+        return false;
+
+    if (budget_ > 0 && totals_.bytes() > budget_)
+    {
+        Purge(renderer, now, "over budget");
+        return true;
+    }
+    if (hidden_purge_at_ >= 0.0 && now >= hidden_purge_at_)
+    {
+        Purge(renderer, now, "app hidden");
+        return true;
+    }
+    return false;
+}
+
+void MemoryManager::Purge(Renderer *renderer, double now, const char *reason)
+{
+    LogMsg("Purging memory (%s): bitmaps %.1f MB, textures %.1f MB, pool %.1f MB, budget %.1f MB",
+           reason, totals_.bitmap_bytes / 1048576.0, totals_.texture_bytes / 1048576.0,
+           totals_.pool_bytes / 1048576.0, budget_ / 1048576.0);
+    for (const AppUsage &app : apps_)
+    {
+        if (app.bitmap_bytes + app.texture_bytes > 0)
+            LogMsg("  %s%s: bitmap %.1f MB, texture %.1f MB", app.name.c_str(), app.visible ? "" : " (hidden)",
+                   app.bitmap_bytes / 1048576.0, app.texture_bytes / 1048576.0);
+    }
+
+    TexturePool::instance().Trim();
+    totals_.pool_bytes = 0;
+    renderer->PurgeMemory();
+    renderer->LogMemoryUsage();
+
+    totals_.purges++;
+    last_purge_ = now;
+    hidden_purge_at_ = -1.0;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <Ultralight/Ultralight.h>
+
+using namespace ultralight;
+
+/**
+ * @brief Tracks SkyScript's memory use and decides when to give some back
+ *
+ * The manager reports per-app usage once per kSampleInterval. Hidden apps
+ * drop their upload texture right away (App::ReleaseGraphics), and
+ * Renderer::PurgeMemory() runs kHiddenPurgeDelay seconds after an app was
+ * hidden, or whenever the total goes over the budget. Purges are at least
+ * kPurgeCooldown apart, PurgeMemory() throws away caches that a busy page
+ * refills on its next paint.
+ *
+ * Texture bytes are the allocated storage of upload textures, bitmap bytes
+ * are view surfaces (CPU) or render targets (GPU). The JS handle caches are
+ * shared by all apps and only counted.
+ */
+class MemoryManager
+{
+public:
+    static constexpr double kSampleInterval = 1.0;
+    static constexpr double kHiddenPurgeDelay = 5.0;
+    static constexpr double kPurgeCooldown = 10.0;
+
+    struct AppUsage
+    {
+        std::string name;
+        bool visible = false;
+        size_t bitmap_bytes = 0;
+        size_t texture_bytes = 0;
+    };
+
+    struct Totals
+    {
+        size_t bitmap_bytes = 0;
+        size_t texture_bytes = 0;   // upload textures in use by apps
+        size_t pool_bytes = 0;      // idle textures kept by TexturePool
+        size_t datarefs = 0;        // JS handle caches
+        size_t objects = 0;
+        size_t instances = 0;
+        size_t probes = 0;
+        uint64_t purges = 0;
+
+        size_t bytes() const { return bitmap_bytes + texture_bytes + pool_bytes; }
+    };
+
+    explicit MemoryManager(size_t budget = 512u << 20) : budget_(budget) {}
+
+    // Total bitmap and texture bytes before a purge is forced, 0 = no limit
+    size_t budget() const { return budget_; }
+    void set_budget(size_t bytes) { budget_ = bytes; }
+
+    // True once kSampleInterval has passed since the last Tick()
+    bool Due(double now) const { return last_sample_ < 0.0 || now - last_sample_ >= kSampleInterval; }
+
+    // An app was hidden, purge once it had time to settle
+    void NoteHidden(double now);
+
+    /**
+     * @brief Record usage and purge if an app was hidden or the budget is exceeded
+     * @return true if Renderer::PurgeMemory() ran
+     */
+    bool Tick(std::vector<AppUsage> usage, Renderer *renderer, double now);
+
+    const Totals &totals() const { return totals_; }
+    const std::vector<AppUsage> &apps() const { return apps_; }
+
+private:
+    void Purge(Renderer *renderer, double now, const char *reason);
+
+    size_t budget_;
+    double last_sample_ = -1.0;
+    double last_purge_ = -1.0;
+    double hidden_purge_at_ = -1.0;
+
+    Totals totals_;
+    std::vector<AppUsage> apps_;
+};
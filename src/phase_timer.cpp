@@ -0,0 +1,45 @@
+#include "phase_timer.h"
+
+#include <algorithm>
+
+void PhaseTimer::Add(double seconds)
+{
+    samples_[next_sample_] = seconds;
+    next_sample_ = (next_sample_ + 1) % kWindow;
+    sample_count_ = std::min(sample_count_ + 1, kWindow);
+    total_samples_++;
+    stats_.last_ms = seconds * 1000.0;
+    dirty_ = true;
+}
+
+void PhaseTimer::Reset()
+{
+    sample_count_ = 0;
+    next_sample_ = 0;
+    stats_ = Stats();
+    dirty_ = false;
+}
+
+const PhaseTimer::Stats &PhaseTimer::stats() const
+{
+    if (!dirty_)
+        return stats_;
+    dirty_ = false;
+    if (sample_count_ == 0)
+        return stats_;
+
+    double sorted[kWindow];
+    std::copy(samples_, samples_ + sample_count_, sorted);
+    std::sort(sorted, sorted + sample_count_);
+
+    double sum = 0.0;
+    for (int i = 0; i < sample_count_; i++)
+        sum += sorted[i];
+
+    // Nearest rank: the smallest sample with at least 99% of the window at or below it
+    int rank = (sample_count_ * 99 + 99) / 100;
+    stats_.min_ms = sorted[0] * 1000.0;
+    stats_.avg_ms = sum / sample_count_ * 1000.0;
+    stats_.p99_ms = sorted[std::clamp(rank, 1, sample_count_) - 1] * 1000.0;
+    return stats_;
+}
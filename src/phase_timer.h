@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Rolling min/avg/p99 of one per-frame phase
+ *
+ * Add() takes one sample per sim frame. The statistics cover the last
+ * kWindow samples and are recomputed on the first read after a new sample,
+ * so readers polling every frame (datarefs) cost one sort per frame.
+ */
+class PhaseTimer
+{
+public:
+    static constexpr int kWindow = 300;  // about 5 s at 60 fps
+
+    struct Stats
+    {
+        double last_ms = 0.0;
+        double min_ms = 0.0;
+        double avg_ms = 0.0;
+        double p99_ms = 0.0;
+    };
+
+    void Add(double seconds);
+
+    // Forget the history, all statistics read 0 until the next sample
+    void Reset();
+
+    const Stats &stats() const;
+    uint64_t samples() const { return total_samples_; }
+
+private:
+    double samples_[kWindow] = {};
+    int sample_count_ = 0;
+    int next_sample_ = 0;
+    uint64_t total_samples_ = 0;
+
+    mutable bool dirty_ = false;
+    mutable Stats stats_;
+};
@@ -0,0 +1,85 @@
+#include "texture_pool.h"
+
+TexturePool &TexturePool::instance()
+{
+    static TexturePool instance;
+    return instance;
+}
+
+GLuint TexturePool::Acquire(uint32_t width, uint32_t height, uint32_t &storage_width, uint32_t &storage_height)
+{
+    storage_width = BucketSize(width);
+    storage_height = BucketSize(height);
+
+    for (auto it = free_.begin(); it != free_.end(); ++it)
+    {
+        if (it->width == storage_width && it->height == storage_height)
+        {
+            GLuint texture = it->texture;
+            free_.erase(it);
+            reuses_++;
+            return texture;
+        }
+    }
+
+    allocations_++;
+    return Allocate(storage_width, storage_height);
+}
+
+void TexturePool::Release(GLuint texture, uint32_t storage_width, uint32_t storage_height)
+{
+    if (texture == 0)
+        return;
+
+    free_.push_back({texture, storage_width, storage_height});
+    if (free_.size() > kMaxFree)
+    {
+        glDeleteTextures(1, &free_.front().texture);
+        free_.erase(free_.begin());
+    }
+}
+
+void TexturePool::Trim()
+{
+    for (Entry &entry : free_)
+        glDeleteTextures(1, &entry.texture);
+    free_.clear();
+}
+
+size_t TexturePool::free_bytes() const
+{
+    size_t bytes = 0;
+    for (const Entry &entry : free_)
+        bytes += static_cast<size_t>(entry.width) * entry.height * 4;
+    return bytes;
+}
+
+GLuint TexturePool::Allocate(uint32_t width, uint32_t height)
+{
+    GLExt::Load();
+
+    GLint prev_texture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &prev_texture);
+
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    if (GLExt::HasTexStorage())
+    {
+        GLExt::TexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    }
+    else
+    {
+        // Allocate once without data, all uploads go through glTexSubImage2D
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height,
+                     0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, prev_texture);
+    return texture;
+}
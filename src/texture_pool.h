@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gl_ext.h"
+
+/**
+ * @brief Reuses RGBA8 textures across window resizes
+ *
+ * Storage sizes are rounded up to kBucket pixels in each direction, so a
+ * window dragged a few pixels wider keeps its texture and only the sampled
+ * part changes. Textures given back with Release() are kept for the next
+ * Acquire() of the same bucket, up to kMaxFree of them. All textures are
+ * immutable (glTexStorage2D) when the context supports it.
+ */
+class TexturePool
+{
+public:
+    static constexpr uint32_t kBucket = 256;  // storage granularity in pixels
+    static constexpr size_t kMaxFree = 4;     // idle textures kept for reuse
+
+    static TexturePool &instance();
+
+    // Storage size used for a texture holding width x height pixels
+    static uint32_t BucketSize(uint32_t size) { return (size + kBucket - 1) / kBucket * kBucket; }
+
+    /**
+     * @brief Get a texture with room for width x height pixels
+     * @param width Pixels needed horizontally
+     * @param height Pixels needed vertically
+     * @param storage_width Allocated width, a multiple of kBucket
+     * @param storage_height Allocated height, a multiple of kBucket
+     * @return Texture name, contents undefined
+     */
+    GLuint Acquire(uint32_t width, uint32_t height, uint32_t &storage_width, uint32_t &storage_height);
+
+    // Hand a texture from Acquire() back for reuse
+    void Release(GLuint texture, uint32_t storage_width, uint32_t storage_height);
+
+    // Delete all idle textures
+    void Trim();
+
+    size_t free_count() const { return free_.size(); }
+    size_t free_bytes() const;
+    uint64_t allocations() const { return allocations_; }
+    uint64_t reuses() const { return reuses_; }
+
+private:
+    TexturePool() = default;
+
+    struct Entry {
+        GLuint texture = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    GLuint Allocate(uint32_t width, uint32_t height);
+
+    std::vector<Entry> free_;  // oldest first
+    uint64_t allocations_ = 0;
+    uint64_t reuses_ = 0;
+};
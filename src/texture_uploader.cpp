@@ -0,0 +1,348 @@
+#include "texture_uploader.h"
+
+#include <cstring>
+
+#include "log_msg.h"
+
+TextureUploader::PixelBufferMode TextureUploader::pixel_buffer_mode_ = TextureUploader::kPixelBuffersAuto;
+TextureUploader::PathTiming TextureUploader::calibration_[2];
+int TextureUploader::calibrated_ = -1;
+
+TextureUploader::~TextureUploader()
+{
+    Reset();
+}
+
+void TextureUploader::Reset()
+{
+    if (texture_id_ != 0)
+    {
+        TexturePool::instance().Release(texture_id_, storage_width_, storage_height_);
+        texture_id_ = 0;
+    }
+    tex_width_ = 0;
+    tex_height_ = 0;
+    storage_width_ = 0;
+    storage_height_ = 0;
+    ReleaseRing();
+}
+
+void TextureUploader::ReleaseRing()
+{
+    for (RingSlot &slot : ring_)
+    {
+        if (slot.fence)
+            GLExt::DeleteSync(slot.fence);
+        if (slot.pbo)
+            GLExt::DeleteBuffers(1, &slot.pbo);
+        slot = RingSlot();
+    }
+    next_slot_ = 0;
+}
+
+bool TextureUploader::NeedsAllocation(uint32_t width, uint32_t height) const
+{
+    return texture_id_ == 0 || width != tex_width_ || height != tex_height_;
+}
+
+bool TextureUploader::NeedsStorage(uint32_t width, uint32_t height) const
+{
+    return texture_id_ == 0 || TexturePool::BucketSize(width) != storage_width_ ||
+           TexturePool::BucketSize(height) != storage_height_;
+}
+
+Rect TextureUploader::uv() const
+{
+    if (storage_width_ == 0 || storage_height_ == 0)
+        return {0.0f, 0.0f, 1.0f, 1.0f};
+    return {0.0f, 0.0f, static_cast<float>(tex_width_) / storage_width_,
+            static_cast<float>(tex_height_) / storage_height_};
+}
+
+void TextureUploader::AllocateStorage(uint32_t width, uint32_t height)
+{
+    // Same bucket: keep the texture, the caller uploads the whole surface again
+    if (NeedsStorage(width, height))
+    {
+        TexturePool &pool = TexturePool::instance();
+        if (texture_id_ != 0)
+            pool.Release(texture_id_, storage_width_, storage_height_);
+        texture_id_ = pool.Acquire(width, height, storage_width_, storage_height_);
+    }
+
+    tex_width_ = width;
+    tex_height_ = height;
+}
+
+size_t TextureUploader::Upload(Surface *surface)
+{
+    last_upload_bytes_ = 0;
+    last_upload_us_ = 0.0;
+
+    if (!surface || surface->width() == 0 || surface->height() == 0)
+        return 0;
+
+    uint32_t width = surface->width();
+    uint32_t height = surface->height();
+    IntRect dirty = surface->dirty_bounds();
+
+    // Nothing changed since the last upload, don't even lock the pixels
+    if (!NeedsAllocation(width, height) && !dirty.IsValid())
+    {
+        surface->ClearDirtyBounds();
+        return 0;
+    }
+
+    void *pixels = surface->LockPixels();
+    size_t bytes = pixels ? Upload(pixels, width, height, surface->row_bytes(), dirty) : 0;
+    surface->UnlockPixels();
+    surface->ClearDirtyBounds();
+    return bytes;
+}
+
+bool TextureUploader::BeginUpload(uint32_t width, uint32_t height, const IntRect &dirty, IntRect &rect)
+{
+    GLExt::Load();
+
+    upload_start_ = std::chrono::steady_clock::now();
+    IntRect bounds = {0, 0, static_cast<int>(width), static_cast<int>(height)};
+
+    // Fresh or resized storage has undefined contents, upload everything
+    bool allocate = NeedsAllocation(width, height);
+    rect = allocate ? bounds : dirty.Intersect(bounds);
+    if (!rect.IsValid())
+        return false;
+
+    // X-Plane caches its own texture bindings, leave unit 0 as we found it
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &prev_texture_);
+
+    // A bound unpack buffer would turn client pointers into buffer offsets
+    prev_buffer_ = 0;
+    if (GLExt::HasPixelBuffers())
+    {
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &prev_buffer_);
+        if (prev_buffer_ != 0)
+            GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    if (allocate)
+        AllocateStorage(width, height);
+    glBindTexture(GL_TEXTURE_2D, texture_id_);
+
+    glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    return true;
+}
+
+size_t TextureUploader::EndUpload(const IntRect &rect)
+{
+    glPopClientAttrib();
+    glBindTexture(GL_TEXTURE_2D, prev_texture_);
+    if (prev_buffer_ != 0)
+        GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, prev_buffer_);
+
+    last_upload_bytes_ = static_cast<size_t>(rect.width()) * rect.height() * 4;
+    last_upload_us_ = std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - upload_start_).count();
+    return last_upload_bytes_;
+}
+
+size_t TextureUploader::Upload(UploadSurface *surface)
+{
+    // Host memory backed surfaces take the regular client-memory paths
+    if (!surface || surface->pixel_buffer() == 0)
+        return Upload(static_cast<Surface *>(surface));
+
+    last_upload_bytes_ = 0;
+    last_upload_us_ = 0.0;
+
+    uint32_t width = surface->width();
+    uint32_t height = surface->height();
+    if (width == 0 || height == 0)
+        return 0;
+
+    // Nothing painted since the last upload
+    if (!NeedsAllocation(width, height) && !surface->upload_pending())
+        return 0;
+
+    IntRect rect;
+    if (!BeginUpload(width, height, surface->dirty_bounds(), rect))
+    {
+        surface->ClearDirtyBounds();
+        return 0;
+    }
+
+    // Source the copy directly from the buffer Ultralight painted into
+    uint32_t row_bytes = surface->row_bytes();
+    size_t offset = static_cast<size_t>(rect.top) * row_bytes + static_cast<size_t>(rect.left) * 4;
+
+    GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, surface->pixel_buffer());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, row_bytes / 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.left, rect.top, rect.width(), rect.height(),
+                    GL_BGRA, GL_UNSIGNED_BYTE, reinterpret_cast<const void *>(offset));
+    ReplicateEdges(0, row_bytes, rect);
+    GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // The next paint into this surface must wait for the copy to finish
+    surface->SetUploadFence(GLExt::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    surface->ClearDirtyBounds();
+
+    return EndUpload(rect);
+}
+
+size_t TextureUploader::Upload(const void *pixels, uint32_t width, uint32_t height, uint32_t row_bytes,
+                               const IntRect &dirty)
+{
+    last_upload_bytes_ = 0;
+    last_upload_us_ = 0.0;
+
+    if (!pixels || width == 0 || height == 0)
+        return 0;
+
+    IntRect rect;
+    if (!BeginUpload(width, height, dirty, rect))
+        return 0;
+
+    // Surfaces are always BGRA8, row_bytes may carry Config::bitmap_alignment padding
+    const uint8_t *origin = static_cast<const uint8_t *>(pixels) +
+                            static_cast<size_t>(rect.top) * row_bytes +
+                            static_cast<size_t>(rect.left) * 4;
+
+    size_t size = static_cast<size_t>(rect.width()) * rect.height() * 4;
+    bool pixel_buffers = UsePixelBuffers(size) && UploadPixelBuffer(origin, row_bytes, rect);
+    if (!pixel_buffers)
+    {
+        UploadDirect(origin, row_bytes, rect);
+    }
+    ReplicateEdges(reinterpret_cast<uintptr_t>(pixels), row_bytes, rect);
+
+    size_t bytes = EndUpload(rect);
+    NoteUpload(pixel_buffers, bytes, last_upload_us_);
+    return bytes;
+}
+
+bool TextureUploader::UsePixelBuffers(size_t bytes)
+{
+    if (!GLExt::HasPixelBuffers() || pixel_buffer_mode_ == kPixelBuffersOff)
+        return false;
+    if (pixel_buffer_mode_ == kPixelBuffersOn)
+        return true;
+    if (calibrated_ >= 0)
+        return calibrated_ == 1;
+
+    // Still measuring: alternate between the paths, small uploads stay direct
+    return bytes >= kCalibrationMinBytes && calibration_[1].uploads < calibration_[0].uploads;
+}
+
+void TextureUploader::NoteUpload(bool pixel_buffers, size_t bytes, double us)
+{
+    if (pixel_buffer_mode_ != kPixelBuffersAuto || calibrated_ >= 0 || bytes < kCalibrationMinBytes ||
+        !GLExt::HasPixelBuffers())
+        return;
+
+    PathTiming &timing = calibration_[pixel_buffers ? 1 : 0];
+    timing.us += us;
+    timing.bytes += bytes;
+    timing.uploads++;
+    if (calibration_[0].uploads < kCalibrationUploads || calibration_[1].uploads < kCalibrationUploads)
+        return;
+
+    double direct = calibration_[0].us / (calibration_[0].bytes / 1048576.0);
+    double ring = calibration_[1].us / (calibration_[1].bytes / 1048576.0);
+    calibrated_ = ring < direct ? 1 : 0;
+    LogMsg("TextureUploader: direct uploads block %.0f us/MB, the PBO ring %.0f us/MB, using %s",
+           direct, ring, calibrated_ ? "the PBO ring" : "direct uploads");
+}
+
+void TextureUploader::UploadDirect(const uint8_t *origin, uint32_t row_bytes, const IntRect &rect)
+{
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, row_bytes / 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.left, rect.top, rect.width(), rect.height(),
+                    GL_BGRA, GL_UNSIGNED_BYTE, origin);
+}
+
+void TextureUploader::ReplicateEdges(uintptr_t base, uint32_t row_bytes, const IntRect &rect)
+{
+    // Pooled storage is larger than the surface and GL_LINEAR samples half a texel past
+    // the edge when the window is scaled, repeat the edge instead of leaving stale texels
+    bool right = rect.right == static_cast<int>(tex_width_) && tex_width_ < storage_width_;
+    bool bottom = rect.bottom == static_cast<int>(tex_height_) && tex_height_ < storage_height_;
+    if (!right && !bottom)
+        return;
+
+    auto at = [&](uint32_t x, uint32_t y) {
+        return reinterpret_cast<const void *>(base + static_cast<size_t>(y) * row_bytes + static_cast<size_t>(x) * 4);
+    };
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, row_bytes / 4);
+    if (right)
+        glTexSubImage2D(GL_TEXTURE_2D, 0, tex_width_, rect.top, 1, rect.height(),
+                        GL_BGRA, GL_UNSIGNED_BYTE, at(tex_width_ - 1, rect.top));
+    if (bottom)
+        glTexSubImage2D(GL_TEXTURE_2D, 0, rect.left, tex_height_, rect.width(), 1,
+                        GL_BGRA, GL_UNSIGNED_BYTE, at(rect.left, tex_height_ - 1));
+    if (right && bottom)
+        glTexSubImage2D(GL_TEXTURE_2D, 0, tex_width_, tex_height_, 1, 1,
+                        GL_BGRA, GL_UNSIGNED_BYTE, at(tex_width_ - 1, tex_height_ - 1));
+}
+
+bool TextureUploader::UploadPixelBuffer(const uint8_t *origin, uint32_t row_bytes, const IntRect &rect)
+{
+    RingSlot &slot = ring_[next_slot_];
+
+    // A slot whose previous copy hasn't finished would stall in the map,
+    // take the direct path for this frame instead
+    if (slot.fence)
+    {
+        GLenum status = GLExt::ClientWaitSync(slot.fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED)
+            return false;
+        GLExt::DeleteSync(slot.fence);
+        slot.fence = nullptr;
+    }
+
+    size_t packed_row = static_cast<size_t>(rect.width()) * 4;
+    size_t size = packed_row * rect.height();
+
+    if (slot.pbo == 0)
+        GLExt::GenBuffers(1, &slot.pbo);
+    GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+
+    if (slot.capacity < size)
+    {
+        GLExt::BufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        slot.capacity = size;
+    }
+
+    // The fence already proved the GPU is done with this slot
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+    if (GLExt::HasSync())
+        access |= GL_MAP_UNSYNCHRONIZED_BIT;
+
+    uint8_t *dst = static_cast<uint8_t *>(GLExt::MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, access));
+    if (!dst)
+    {
+        GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+
+    // Pack the dirty rows tightly, a blinking cursor is a few hundred bytes not a full stride
+    for (int y = 0; y < rect.height(); y++)
+    {
+        memcpy(dst + y * packed_row, origin + static_cast<size_t>(y) * row_bytes, packed_row);
+    }
+    GLExt::UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.left, rect.top, rect.width(), rect.height(),
+                    GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+
+    GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (GLExt::HasSync())
+        slot.fence = GLExt::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    next_slot_ = (next_slot_ + 1) % kRingSize;
+    return true;
+}
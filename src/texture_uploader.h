@@ -0,0 +1,155 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <Ultralight/Ultralight.h>
+
+#include "gl_ext.h"
+#include "texture_pool.h"
+#include "upload_surface.h"
+
+using namespace ultralight;
+
+/**
+ * @brief Uploads the dirty part of an Ultralight surface into a GL texture
+ *
+ * The texture comes from TexturePool, so its storage is rounded up to the
+ * pool's bucket size and only the top-left width() x height() pixels hold
+ * the surface (see uv()). The surface's last column and row are repeated
+ * just outside it, so a window drawn scaled never blends in stale texels from
+ * an earlier user of the texture. A resize within the same bucket keeps the texture,
+ * otherwise it is swapped for a pooled one. Only the surface's dirty
+ * rectangle is sent with glTexSubImage2D. Row padding from Config::bitmap_alignment is
+ * handled through GL_UNPACK_ROW_LENGTH, so no repacking copy is needed.
+ *
+ * When pixel buffer objects are available the dirty rectangle can be staged
+ * through a small ring of PBOs guarded by fences, so glTexSubImage2D returns
+ * immediately and the GPU copy overlaps the next sim frame. The extra copy into
+ * the PBO is not free, and on some drivers (Mesa software GL among them) the
+ * ring blocks longer than the direct client-memory path. By default the first
+ * kCalibrationUploads large uploads of each path are timed and the one that
+ * blocked for less time per byte is kept for the rest of the session. Without
+ * PBOs, or when every ring slot is still in flight, the direct path is used.
+ *
+ * An UploadSurface backed by a persistently mapped buffer skips both: the
+ * texture is copied straight out of the buffer Ultralight painted into.
+ */
+class TextureUploader {
+public:
+    static constexpr int kRingSize = 3;
+    static constexpr int kCalibrationUploads = 32;            // per path, before kPixelBuffersAuto decides
+    static constexpr size_t kCalibrationMinBytes = 64 << 10;  // smaller uploads are too noisy to compare
+
+    enum PixelBufferMode {
+        kPixelBuffersAuto,  // measure both paths, keep the faster one
+        kPixelBuffersOff,
+        kPixelBuffersOn,
+    };
+
+    TextureUploader() = default;
+    ~TextureUploader();
+
+    TextureUploader(const TextureUploader &) = delete;
+    TextureUploader &operator=(const TextureUploader &) = delete;
+
+    /**
+     * @brief Upload the surface's dirty bounds and clear them
+     * @param surface The view surface to read from
+     * @return Number of pixel bytes sent to GL
+     */
+    size_t Upload(Surface *surface);
+
+    /**
+     * @brief Upload a pending UploadSurface, sourcing from its mapped buffer when it has one
+     * @param surface The view surface created by UploadSurfaceFactory
+     * @return Number of pixel bytes sent to GL
+     */
+    size_t Upload(UploadSurface *surface);
+
+    /**
+     * @brief Upload a rectangle from BGRA8 client memory
+     * @param pixels Top-left pixel of the full image
+     * @param width Image width in pixels
+     * @param height Image height in pixels
+     * @param row_bytes Image stride in bytes (may include alignment padding)
+     * @param dirty Region to upload, ignored when the texture is (re)allocated
+     * @return Number of pixel bytes sent to GL
+     */
+    size_t Upload(const void *pixels, uint32_t width, uint32_t height, uint32_t row_bytes,
+                  const IntRect &dirty);
+
+    /**
+     * @brief Return the texture to the pool and delete the PBO ring, the next Upload() reallocates them
+     */
+    void Reset();
+
+    // Whether client-memory uploads go through the PBO ring, for all uploaders
+    static void set_pixel_buffer_mode(PixelBufferMode mode) { pixel_buffer_mode_ = mode; }
+    static PixelBufferMode pixel_buffer_mode() { return pixel_buffer_mode_; }
+
+    GLuint texture() const { return texture_id_; }
+    uint32_t width() const { return tex_width_; }
+    uint32_t height() const { return tex_height_; }
+    uint32_t storage_width() const { return storage_width_; }
+    uint32_t storage_height() const { return storage_height_; }
+
+    // Part of the texture holding the surface
+    Rect uv() const;
+
+    // Bytes sent by the last Upload() call
+    size_t last_upload_bytes() const { return last_upload_bytes_; }
+
+    // Time the last Upload() call blocked the calling thread, in microseconds
+    double last_upload_us() const { return last_upload_us_; }
+
+private:
+    struct RingSlot {
+        GLuint pbo = 0;
+        size_t capacity = 0;
+        GLExtSync fence = nullptr;
+    };
+
+    // Stall time of one path during calibration
+    struct PathTiming {
+        double us = 0.0;
+        size_t bytes = 0;
+        int uploads = 0;
+    };
+
+    static bool UsePixelBuffers(size_t bytes);
+    static void NoteUpload(bool pixel_buffers, size_t bytes, double us);
+
+    bool NeedsAllocation(uint32_t width, uint32_t height) const;
+    bool NeedsStorage(uint32_t width, uint32_t height) const;
+    bool BeginUpload(uint32_t width, uint32_t height, const IntRect &dirty, IntRect &rect);
+    size_t EndUpload(const IntRect &rect);
+    void AllocateStorage(uint32_t width, uint32_t height);
+    void UploadDirect(const uint8_t *origin, uint32_t row_bytes, const IntRect &rect);
+    bool UploadPixelBuffer(const uint8_t *origin, uint32_t row_bytes, const IntRect &rect);
+    // base is the surface's first pixel, a buffer offset while an unpack buffer is bound
+    void ReplicateEdges(uintptr_t base, uint32_t row_bytes, const IntRect &rect);
+    void ReleaseRing();
+
+    GLuint texture_id_ = 0;
+    uint32_t tex_width_ = 0;
+    uint32_t tex_height_ = 0;
+    uint32_t storage_width_ = 0;
+    uint32_t storage_height_ = 0;
+
+    static PixelBufferMode pixel_buffer_mode_;
+    static PathTiming calibration_[2];  // direct, PBO ring
+    static int calibrated_;             // -1 while measuring, else 1 if the ring won
+
+    RingSlot ring_[kRingSize];
+    int next_slot_ = 0;
+
+    size_t last_upload_bytes_ = 0;
+    double last_upload_us_ = 0.0;
+
+    // GL state saved between BeginUpload() and EndUpload()
+    GLint prev_texture_ = 0;
+    GLint prev_buffer_ = 0;
+    std::chrono::steady_clock::time_point upload_start_;
+};
@@ -0,0 +1,40 @@
+#include "update_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+bool UpdateScheduler::Tick(Renderer *renderer)
+{
+    if (!renderer)
+        return false;
+
+    // Pay back the last overrun before taking more time out of the sim frame
+    if (debt_ > 0.0 && deferred_in_row_ < kMaxDeferredFrames)
+    {
+        debt_ = std::max(0.0, debt_ - budget_);
+        deferred_in_row_++;
+        stats_.deferred++;
+        stats_.debt_ms = debt_ * 1000.0;
+        return false;
+    }
+    deferred_in_row_ = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    renderer->Update();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (elapsed > budget_)
+    {
+        debt_ += elapsed - budget_;
+        stats_.over_budget++;
+    }
+    else
+    {
+        // A run that hit the deferral limit may leave debt behind, unused budget pays it down
+        debt_ = std::max(0.0, debt_ - (budget_ - elapsed));
+    }
+
+    stats_.runs++;
+    stats_.debt_ms = debt_ * 1000.0;
+    return true;
+}
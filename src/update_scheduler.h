@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <Ultralight/Ultralight.h>
+
+using namespace ultralight;
+
+/**
+ * @brief Drives Renderer::Update() within a per-frame time budget
+ *
+ * Renderer::Update() runs JS timers, layout and network callbacks in one go.
+ * Ultralight already throttles repeating timers to Config::max_update_time,
+ * which is set to a share of the budget (timer_budget()). Whatever else lands
+ * in the same call is measured: time spent over budget becomes a debt that is
+ * paid back by skipping Update() on the following frames, so a 15 ms spike
+ * costs a few frames without updates instead of being followed by more work.
+ * At most kMaxDeferredFrames updates are skipped in a row to keep timers and
+ * network callbacks moving.
+ *
+ * The budget is set by the manager as a share of its frame budget. Timing
+ * statistics are the manager's kPhaseUpdate, the counters here say how often
+ * the budget was exceeded and frames were skipped.
+ */
+class UpdateScheduler
+{
+public:
+    static constexpr int kMaxDeferredFrames = 4;  // longest run of skipped updates
+
+    struct Stats
+    {
+        double debt_ms = 0.0;      // over-budget time still to be paid back
+        uint64_t runs = 0;         // Update() calls since start
+        uint64_t deferred = 0;     // frames skipped to pay back debt
+        uint64_t over_budget = 0;  // calls that exceeded the budget
+    };
+
+    // Per-frame Update() budget in seconds
+    double budget() const { return budget_; }
+    void set_budget(double seconds) { budget_ = seconds; }
+
+    // Share of the budget handed to Ultralight's timer throttling (Config::max_update_time)
+    double timer_budget() const { return budget_ * 0.75; }
+
+    /**
+     * @brief Call once per sim frame, runs or defers Renderer::Update()
+     * @return true if Update() ran this frame
+     */
+    bool Tick(Renderer *renderer);
+
+    const Stats &stats() const { return stats_; }
+
+private:
+    double budget_ = 0.0;
+    double debt_ = 0.0;
+    int deferred_in_row_ = 0;
+
+    Stats stats_;
+};
@@ -0,0 +1,173 @@
+#include "upload_surface.h"
+#include "log_msg.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if IBM
+#include <malloc.h>
+#endif
+
+// Page alignment keeps rows SIMD aligned and lets drivers pin the memory
+static constexpr size_t kPageSize = 4096;
+
+static void *AllocatePages(size_t size)
+{
+    size = (size + kPageSize - 1) & ~(kPageSize - 1);
+#if IBM
+    return _aligned_malloc(size, kPageSize);
+#else
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, kPageSize, size) != 0)
+        return nullptr;
+    return ptr;
+#endif
+}
+
+static void FreePages(void *ptr)
+{
+#if IBM
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+UploadSurface::UploadSurface(uint32_t width, uint32_t height)
+    : width_(width), height_(height)
+{
+    Allocate();
+}
+
+UploadSurface::~UploadSurface()
+{
+    Release();
+}
+
+void UploadSurface::Allocate()
+{
+    // Honor Config::bitmap_alignment like BitmapSurface does
+    uint32_t alignment = Platform::instance().config().bitmap_alignment;
+    row_bytes_ = width_ * 4;
+    if (alignment > 1)
+        row_bytes_ = (row_bytes_ + alignment - 1) / alignment * alignment;
+    size_ = static_cast<size_t>(row_bytes_) * height_;
+
+    if (size_ == 0)
+        return;
+
+    GLExt::Load();
+    if (GLExt::HasBufferStorage())
+    {
+        // The CPU rasterizer reads back while blending, ask for cached client memory
+        const GLbitfield map_flags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT |
+                                     GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        GLint prev_buffer = 0;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &prev_buffer);
+
+        GLExt::GenBuffers(1, &pbo_);
+        GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_);
+        GLExt::BufferStorage(GL_PIXEL_UNPACK_BUFFER, size_, nullptr, map_flags | GL_CLIENT_STORAGE_BIT);
+        pixels_ = GLExt::MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size_, map_flags);
+        GLExt::BindBuffer(GL_PIXEL_UNPACK_BUFFER, prev_buffer);
+
+        if (!pixels_)
+        {
+            LogMsg("UploadSurface: persistent map of %zu bytes failed, using host memory", size_);
+            GLExt::DeleteBuffers(1, &pbo_);
+            pbo_ = 0;
+        }
+    }
+
+    if (!pixels_)
+        pixels_ = AllocatePages(size_);
+
+    if (pixels_)
+        memset(pixels_, 0, size_);
+}
+
+void UploadSurface::Release()
+{
+    if (fence_)
+    {
+        GLExt::DeleteSync(fence_);
+        fence_ = nullptr;
+    }
+
+    if (pbo_)
+    {
+        // Deleting a mapped buffer unmaps it
+        GLExt::DeleteBuffers(1, &pbo_);
+        pbo_ = 0;
+    }
+    else if (pixels_)
+    {
+        FreePages(pixels_);
+    }
+    pixels_ = nullptr;
+}
+
+void UploadSurface::Resize(uint32_t width, uint32_t height)
+{
+    if (width == width_ && height == height_)
+        return;
+
+    Release();
+    width_ = width;
+    height_ = height;
+    Allocate();
+    Surface::ClearDirtyBounds();
+    upload_pending_ = false;
+}
+
+void UploadSurface::set_dirty_bounds(const IntRect &bounds)
+{
+    Surface::set_dirty_bounds(bounds);
+    upload_pending_ = true;
+}
+
+void UploadSurface::ClearDirtyBounds()
+{
+    Surface::ClearDirtyBounds();
+    upload_pending_ = false;
+}
+
+bool UploadSurface::IsUploadComplete()
+{
+    if (!fence_)
+        return true;
+
+    // Never block the sim thread, a copy that is still running delays the next paint instead
+    GLenum status = GLExt::ClientWaitSync(fence_, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status == GL_TIMEOUT_EXPIRED)
+        return false;
+    if (status == GL_WAIT_FAILED)
+        LogMsg("UploadSurface: wait for texture copy failed (0x%x)", status);
+
+    GLExt::DeleteSync(fence_);
+    fence_ = nullptr;
+    return true;
+}
+
+UploadSurfaceFactory &UploadSurfaceFactory::instance()
+{
+    static UploadSurfaceFactory instance;
+    return instance;
+}
+
+void UploadSurfaceFactory::Install()
+{
+    Platform::instance().set_surface_factory(this);
+    installed_ = true;
+}
+
+Surface *UploadSurfaceFactory::CreateSurface(uint32_t width, uint32_t height)
+{
+    return new UploadSurface(width, height);
+}
+
+void UploadSurfaceFactory::DestroySurface(Surface *surface)
+{
+    delete static_cast<UploadSurface *>(surface);
+}
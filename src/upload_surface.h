@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <Ultralight/Ultralight.h>
+
+#include "gl_ext.h"
+
+using namespace ultralight;
+
+/**
+ * @brief View surface that Ultralight paints straight into upload memory
+ *
+ * The pixels live in a persistently mapped pixel unpack buffer when the
+ * context supports glBufferStorage, so TextureUploader can source
+ * glTexSubImage2D from the buffer with no intermediate copy. Otherwise the
+ * pixels live in page-aligned host memory and are uploaded through the
+ * regular client-memory path.
+ *
+ * Painting must not overwrite a region the GPU is still copying from, so the
+ * uploader leaves a fence on the surface, and the view must not be rendered
+ * until IsUploadComplete() returns true.
+ */
+class UploadSurface : public Surface {
+public:
+    UploadSurface(uint32_t width, uint32_t height);
+    virtual ~UploadSurface();
+
+    UploadSurface(const UploadSurface &) = delete;
+    UploadSurface &operator=(const UploadSurface &) = delete;
+
+    // Surface overrides
+    virtual uint32_t width() const override { return width_; }
+    virtual uint32_t height() const override { return height_; }
+    virtual uint32_t row_bytes() const override { return row_bytes_; }
+    virtual size_t size() const override { return size_; }
+    virtual void *LockPixels() override { return pixels_; }
+    virtual void UnlockPixels() override {}
+    virtual void Resize(uint32_t width, uint32_t height) override;
+    virtual void set_dirty_bounds(const IntRect &bounds) override;
+    virtual void ClearDirtyBounds() override;
+
+    // Pixels were painted since the last upload
+    bool upload_pending() const { return upload_pending_; }
+
+    // Backing buffer when persistently mapped, 0 for host memory
+    GLuint pixel_buffer() const { return pbo_; }
+
+    // Called by the uploader after it sourced a copy from pixel_buffer()
+    void SetUploadFence(GLExtSync fence)
+    {
+        if (fence_)
+            GLExt::DeleteSync(fence_);
+        fence_ = fence;
+    }
+
+    // Poll whether the last copy out of pixel_buffer() has completed, never blocks
+    bool IsUploadComplete();
+
+private:
+    void Allocate();
+    void Release();
+
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t row_bytes_ = 0;
+    size_t size_ = 0;
+    void *pixels_ = nullptr;
+
+    GLuint pbo_ = 0;
+    GLExtSync fence_ = nullptr;
+    bool upload_pending_ = false;
+};
+
+/**
+ * @brief SurfaceFactory handing out UploadSurfaces
+ *
+ * Registered with Platform::set_surface_factory() before the Renderer is
+ * created, after which every CPU-rendered view paints into an UploadSurface.
+ */
+class UploadSurfaceFactory : public SurfaceFactory {
+public:
+    static UploadSurfaceFactory &instance();
+
+    // Register with the Ultralight platform, must happen before Renderer::Create()
+    void Install();
+    bool IsInstalled() const { return installed_; }
+
+    virtual Surface *CreateSurface(uint32_t width, uint32_t height) override;
+    virtual void DestroySurface(Surface *surface) override;
+
+private:
+    UploadSurfaceFactory() = default;
+    bool installed_ = false;
+};
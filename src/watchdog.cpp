@@ -0,0 +1,212 @@
+#include "watchdog.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "log_msg.h"
+
+// Timer floor (ms) and render rate cap (fps) per throttle level, level 0 is unthrottled
+static const double kTimerFloor[Watchdog::kMaxThrottle + 1] = {0.0, 50.0, 250.0};
+static const double kThrottleFps[Watchdog::kMaxThrottle + 1] = {0.0, 15.0, 5.0};
+
+// Apps listed in a report
+static const size_t kReportApps = 5;
+
+static const char *const kPhaseNames[Watchdog::kPhaseCount] = {"js", "paint", "upload"};
+
+const char *const Watchdog::kScriptShim = R"JS((function (report) {
+    var floor = 0;
+    var setTimeout_ = window.setTimeout, setInterval_ = window.setInterval;
+    var raf_ = window.requestAnimationFrame, caf_ = window.cancelAnimationFrame;
+    var deferred = {}, next_deferred = -1;
+
+    function timed(fn, args) {
+        return function () {
+            var start = performance.now();
+            try { fn.apply(window, args); }
+            finally { report(performance.now() - start); }
+        };
+    }
+
+    window.setTimeout = function (fn, delay) {
+        if (typeof fn !== 'function') return setTimeout_.apply(window, arguments);
+        return setTimeout_.call(window, timed(fn, Array.prototype.slice.call(arguments, 2)), Math.max(delay || 0, floor));
+    };
+
+    window.setInterval = function (fn, delay) {
+        if (typeof fn !== 'function') return setInterval_.apply(window, arguments);
+        var run = timed(fn, Array.prototype.slice.call(arguments, 2)), last = 0;
+        return setInterval_.call(window, function () {
+            // Intervals created before the throttle skip ticks instead
+            var now = performance.now();
+            if (floor > 0 && now - last < floor) return;
+            last = now;
+            run();
+        }, Math.max(delay || 0, floor));
+    };
+
+    if (raf_) {
+        window.requestAnimationFrame = function (fn) {
+            var run = function (t) {
+                var start = performance.now();
+                try { fn(t); }
+                finally { report(performance.now() - start); }
+            };
+            if (floor <= 0) return raf_.call(window, run);
+            var id = next_deferred--;
+            deferred[id] = setTimeout_.call(window, function () {
+                deferred[id] = -raf_.call(window, function (t) { delete deferred[id]; run(t); });
+            }, floor);
+            return id;
+        };
+        window.cancelAnimationFrame = function (id) {
+            if (id >= 0) return caf_.call(window, id);
+            var handle = deferred[id];
+            delete deferred[id];
+            if (handle > 0) clearTimeout(handle);
+            else if (handle < 0) caf_.call(window, -handle);
+        };
+    }
+
+    Object.defineProperty(window, '__skyscriptSetTimerFloor', {
+        value: function (ms) { floor = ms; }
+    });
+}))JS";
+
+double Watchdog::ThrottleTimerFloor(int level)
+{
+    return kTimerFloor[std::clamp(level, 0, kMaxThrottle)];
+}
+
+double Watchdog::ThrottleFps(int level)
+{
+    return kThrottleFps[std::clamp(level, 0, kMaxThrottle)];
+}
+
+void Watchdog::Note(const std::string &app, Phase phase, double seconds)
+{
+    if (seconds <= 0.0)
+        return;
+    apps_[app].frame[phase] += seconds;
+}
+
+int Watchdog::Throttle(const std::string &app) const
+{
+    auto it = apps_.find(app);
+    return it != apps_.end() ? it->second.throttle : 0;
+}
+
+void Watchdog::Forget(const std::string &app)
+{
+    apps_.erase(app);
+}
+
+void Watchdog::EndFrame(double now, std::vector<std::string> &changed)
+{
+    changed.clear();
+    for (auto &[name, stats] : apps_)
+    {
+        double total = 0.0;
+        for (int p = 0; p < kPhaseCount; p++)
+            total += stats.frame[p];
+        if (total > 0.0)
+            busy_ = true;
+        if (total > frame_budget_)
+            stats.over_budget++;
+
+        // Idle frames count too, the cost that matters is per sim frame
+        std::copy(stats.frame, stats.frame + kPhaseCount, stats.samples[stats.next_sample]);
+        std::fill(stats.frame, stats.frame + kPhaseCount, 0.0);
+        stats.next_sample = (stats.next_sample + 1) % kWindow;
+        stats.sample_count = std::min(stats.sample_count + 1, kWindow);
+
+        std::fill(stats.avg, stats.avg + kPhaseCount, 0.0);
+        stats.avg_total = 0.0;
+        stats.max_total = 0.0;
+        stats.spikes = 0;
+        for (int i = 0; i < stats.sample_count; i++)
+        {
+            double sample = 0.0;
+            for (int p = 0; p < kPhaseCount; p++)
+            {
+                stats.avg[p] += stats.samples[i][p];
+                sample += stats.samples[i][p];
+            }
+            stats.max_total = std::max(stats.max_total, sample);
+            if (sample > frame_budget_)
+                stats.spikes++;
+        }
+        for (int p = 0; p < kPhaseCount; p++)
+        {
+            stats.avg[p] /= stats.sample_count;
+            stats.avg_total += stats.avg[p];
+        }
+
+        int level = stats.throttle;
+        if (!enabled_)
+        {
+            level = 0;
+        }
+        else if (stats.avg_total > rolling_budget_ || stats.spikes >= kMaxSpikes)
+        {
+            if (level < kMaxThrottle && (stats.last_change < 0.0 || now - stats.last_change >= kHoldTime))
+                level++;
+        }
+        else if (level > 0 && stats.spikes == 0 && stats.avg_total < rolling_budget_ * 0.5 &&
+                 now - stats.last_change >= kRecoverTime)
+        {
+            level--;
+        }
+
+        if (level != stats.throttle)
+        {
+            LogMsg("Watchdog: %s throttle %d -> %d, avg %.2f ms, max %.2f ms, %d frame(s) over %.1f ms",
+                   name.c_str(), stats.throttle, level, stats.avg_total * 1000.0, stats.max_total * 1000.0,
+                   stats.spikes, frame_budget_ * 1000.0);
+            stats.throttle = level;
+            stats.last_change = now;
+            changed.push_back(name);
+        }
+    }
+
+    if (!changed.empty())
+    {
+        Report("throttle");
+        last_report_ = now;
+    }
+    else if (busy_ && (last_report_ < 0.0 || now - last_report_ >= kReportInterval))
+    {
+        Report("periodic");
+        last_report_ = now;
+    }
+}
+
+void Watchdog::Report(const char *reason)
+{
+    busy_ = false;
+
+    std::vector<const std::pair<const std::string, AppStats> *> order;
+    for (const auto &entry : apps_)
+    {
+        if (entry.second.max_total > 0.0)
+            order.push_back(&entry);
+    }
+    if (order.empty())
+        return;
+    std::sort(order.begin(), order.end(),
+              [](const auto *a, const auto *b) { return a->second.avg_total > b->second.avg_total; });
+
+    // One line, most expensive first
+    std::string line;
+    char buf[192];
+    for (size_t i = 0; i < order.size() && i < kReportApps; i++)
+    {
+        const AppStats &s = order[i]->second;
+        snprintf(buf, sizeof(buf), "%s%s %.2f/%.2f ms (%s %.2f %s %.2f %s %.2f) %d over, throttle %d",
+                 i ? ", " : "", order[i]->first.c_str(), s.avg_total * 1000.0, s.max_total * 1000.0,
+                 kPhaseNames[kScript], s.avg[kScript] * 1000.0, kPhaseNames[kPaint], s.avg[kPaint] * 1000.0,
+                 kPhaseNames[kUpload], s.avg[kUpload] * 1000.0, s.spikes, s.throttle);
+        line += buf;
+    }
+    LogMsg("Watchdog (%s, avg/max per frame over %d frames): %s", reason, kWindow, line.c_str());
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Attributes main-thread time to apps and throttles the ones that stall the sim
+ *
+ * Every frame the manager reports how long each app spent in its script
+ * callbacks (timers and animation frames, measured in the page, see
+ * kScriptShim), in Render() and in the texture upload. EndFrame() folds the
+ * frame into a kWindow-frame history per app. An app is flagged when its
+ * average over the window exceeds the rolling budget, or when kMaxSpikes of
+ * its frames exceeded the per-frame budget. Flagged apps move up one throttle
+ * level at most every kHoldTime seconds, and back down after kRecoverTime
+ * seconds well within budget. Each level raises the minimum timer delay in the
+ * page and lowers the app's render rate cap (ThrottleTimerFloor/ThrottleFps).
+ *
+ * A one-line report of the most expensive apps is logged every kReportInterval
+ * seconds while any app is busy, and whenever a throttle level changes.
+ */
+class Watchdog
+{
+public:
+    enum Phase
+    {
+        kScript,
+        kPaint,
+        kUpload,
+        kPhaseCount
+    };
+
+    static constexpr int kWindow = 120;              // frames of history per app
+    static constexpr int kMaxSpikes = 3;             // frames over budget in the window before throttling
+    static constexpr int kMaxThrottle = 2;
+    static constexpr double kHoldTime = 2.0;         // seconds between throttle increases
+    static constexpr double kRecoverTime = 10.0;     // seconds within budget before a level is lifted
+    static constexpr double kReportInterval = 30.0;
+
+    // Injected into every page before its scripts run. Wraps setTimeout,
+    // setInterval and requestAnimationFrame to time their callbacks and to
+    // apply the timer floor. Expects the native reporter as its argument and
+    // leaves __skyscriptSetTimerFloor(ms) behind for App::SetThrottle().
+    static const char *const kScriptShim;
+
+    struct AppStats
+    {
+        double frame[kPhaseCount] = {};  // this frame so far
+        double avg[kPhaseCount] = {};    // per frame over the window
+        double avg_total = 0.0;
+        double max_total = 0.0;          // worst frame in the window
+        int spikes = 0;                  // frames over the frame budget in the window
+        uint64_t over_budget = 0;        // frames over the frame budget since start
+        int throttle = 0;
+        double last_change = -1.0;
+
+        double samples[kWindow][kPhaseCount] = {};
+        int sample_count = 0;
+        int next_sample = 0;
+    };
+
+    explicit Watchdog(double frame_budget = 0.008, double rolling_budget = 0.002)
+        : frame_budget_(frame_budget), rolling_budget_(rolling_budget) {}
+
+    // Seconds one app may take in a single frame, and on average over the window
+    double frame_budget() const { return frame_budget_; }
+    double rolling_budget() const { return rolling_budget_; }
+    void set_frame_budget(double seconds) { frame_budget_ = seconds; }
+    void set_rolling_budget(double seconds) { rolling_budget_ = seconds; }
+
+    // Disabled: nothing is throttled, throttled apps are released on the next EndFrame()
+    bool enabled() const { return enabled_; }
+    void set_enabled(bool v) { enabled_ = v; }
+
+    void Note(const std::string &app, Phase phase, double seconds);
+
+    /**
+     * @brief Close the frame, update the statistics and throttle levels
+     * @param changed Filled with the apps whose throttle level changed
+     */
+    void EndFrame(double now, std::vector<std::string> &changed);
+
+    int Throttle(const std::string &app) const;
+
+    // App went away (suspended, shut down), drop its history
+    void Forget(const std::string &app);
+
+    const std::map<std::string, AppStats> &apps() const { return apps_; }
+
+    // Minimum setTimeout/setInterval delay in ms and render rate cap for a throttle level
+    static double ThrottleTimerFloor(int level);
+    static double ThrottleFps(int level);
+
+private:
+    void Report(const char *reason);
+
+    double frame_budget_;
+    double rolling_budget_;
+    bool enabled_ = true;
+    double last_report_ = -1.0;
+    bool busy_ = false;  // some app used time since the last report
+    std::map<std::string, AppStats> apps_;
+};